@@ -307,6 +307,8 @@ function createHTML(json, parentNode = null, rowNr = UINT8_MAX) {
       let tbodyNode = cE("tbody");
       varNode.appendChild(tbodyNode);
 
+      if (variable.ro) varNode.classList.add("sortable"); //rows of read only tables can be sorted by clicking on a header
+
       if (!variable.ro && variable.id != "fileTbl") { //fileTbl has upload file
         let buttonNode = cE("input");
         buttonNode.type = "button";
@@ -329,6 +331,7 @@ function createHTML(json, parentNode = null, rowNr = UINT8_MAX) {
 
       varNode = cE("th");
       varNode.innerText = initCap(variable.id); //label onUI response can change it
+      if (parentNode.classList.contains("sortable")) varNode.addEventListener('click', (event) => {sortTable(event.target);});
 
     } else if (variable.type == "select" || variable.type == "pin" || variable.type == "ip") {
 
@@ -1574,6 +1577,32 @@ function uploadFileWithText(name, text)
   req.send(formData);
 }
 
+//sort the rows of a table on the column of thNode, numbers numerical, clicking again reverses the order (view only, the model is not changed)
+function sortTable(thNode) {
+  let tableNode = thNode.closest("table");
+  let columnNr = Array.from(thNode.parentNode.childNodes).indexOf(thNode);
+  let ascending = thNode.dataset.sort != "asc";
+  for (let node of thNode.parentNode.childNodes) delete node.dataset.sort;
+  thNode.dataset.sort = ascending?"asc":"desc";
+
+  function cellValue(trNode) {
+    let cellNode = trNode.childNodes[columnNr];
+    if (!cellNode) return "";
+    let valueNode = cellNode.querySelector("input, select");
+    let value = valueNode?valueNode.value:cellNode.innerText;
+    return isNaN(parseFloat(value))?value:parseFloat(value);
+  }
+
+  let tbodyNode = tableNode.querySelector("tbody");
+  let rows = Array.from(tbodyNode.querySelectorAll("tr"));
+  rows.sort(function(a,b) {
+    let aValue = cellValue(a), bValue = cellValue(b);
+    let result = (typeof aValue == "number" && typeof bValue == "number")?aValue - bValue:String(aValue).localeCompare(String(bValue));
+    return ascending?result:-result;
+  });
+  for (let trNode of rows) tbodyNode.appendChild(trNode);
+}
+
 function setInstanceTableColumns() {
 
   let tbl = gId("insTbl");
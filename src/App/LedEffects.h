@@ -20,6 +20,8 @@
   #include "../User/UserModMPU6050.h"
 #endif
 
+#include "LedParticles.h"
+
 //utility function
 float distance(float x1, float y1, float z1, float x2, float y2, float z2) {
   return sqrtf((x1-x2)*(x1-x2) + (y1-y2)*(y1-y2) + (z1-z2)*(z1-z2));
@@ -28,14 +30,24 @@ float distance(float x1, float y1, float z1, float x2, float y2, float z2) {
 //should not contain variables/bytes to keep mem as small as possible!!
 class Effect {
 public:
-  virtual const char * name() {return "noname";}
-  virtual const char * tags() {return "";}
-  virtual uint8_t dim() {return _1D;};
+  static constexpr const char *name = "noname";
+  static constexpr const char *tags = "";
+  static constexpr uint8_t dim = _1D;
+
+  //bytes of effectData (controls and loop variables) allocated at once when the effect is selected
+  //  override if the effect needs more, e.g. arrays depending on the size of leds
+  virtual unsigned16 dataSize(Leds &leds) {return 1024;}
+
+  //true if the output only depends on the controls (not on time or input): frames are skipped while the controls do not change
+  virtual bool isStatic() {return false;}
 
   virtual void setup(Leds &leds) {}
 
   virtual void loop(Leds &leds) {}
 
+  //the layer switches to another effect or is removed: release what setup or loop acquired outside effectData (e.g. files)
+  virtual void teardown(Leds &leds) {}
+
   virtual void controls(Leds &leds, JsonObject parentVar) {
     ui->initSelect(parentVar, "pal", 4, false, [&leds](JsonObject var, uint8_t rowNr, uint8_t funType) { switch (funType) { //varFun
       case onUI: {
@@ -63,7 +75,7 @@ public:
           case 7: leds.palette = HeatColors_p; break;
           case 8: { //randomColors
             for (int i=0; i < sizeof(leds.palette.entries) / sizeof(CRGB); i++) {
-              leds.palette[i] = CHSV(random8(), 255, 255); //take the max saturation, max brightness of the colorwheel
+              leds.palette[i] = CHSV(leds.rng.random8(), 255, 255); //take the max saturation, max brightness of the colorwheel
             }
             break;
           }
@@ -77,9 +89,11 @@ public:
 };
 
 class SolidEffect: public Effect {
-  const char * name() {return "Solid";}
-  uint8_t dim() {return _1D;}
-  const char * tags() {return "💡";}
+public:
+  static constexpr const char *name = "Solid";
+  static constexpr uint8_t dim = _1D;
+  static constexpr const char *tags = "💡";
+  bool isStatic() {return true;}
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
@@ -99,9 +113,10 @@ class SolidEffect: public Effect {
 };
 
 class RainbowEffect: public Effect {
-  const char * name() {return "Rainbow";} //make one rainbow? remove the fastled rainbow?
-  uint8_t      dim()  {return _1D;}
-  const char * tags() {return "💡";} //💡 means wled origin
+public:
+  static constexpr const char *name = "Rainbow"; //make one rainbow? remove the fastled rainbow?
+  static constexpr uint8_t dim = _1D;
+  static constexpr const char *tags = "💡"; //💡 means wled origin
 
   void loop(Leds &leds) {
     // UI Variables
@@ -126,9 +141,10 @@ class RainbowEffect: public Effect {
 };
 
 class RainbowWithGlitterEffect: public Effect {
-  const char * name() {return "Rainbow with glitter";}
-  uint8_t dim() {return _1D;}
-  const char * tags() {return "⚡";} //⚡ means FastLED origin
+public:
+  static constexpr const char *name = "Rainbow with glitter";
+  static constexpr uint8_t dim = _1D;
+  static constexpr const char *tags = "⚡"; //⚡ means FastLED origin
 
   void loop(Leds &leds) {
     uint8_t glitter = leds.effectData.read<bool>();
@@ -143,8 +159,8 @@ class RainbowWithGlitterEffect: public Effect {
 
   void addGlitter(Leds &leds, fract8 chanceOfGlitter) 
   {
-    if( random8() < chanceOfGlitter) {
-      leds[ random16(leds.nrOfLeds) ] += CRGB::White;
+    if( leds.rng.random8() < chanceOfGlitter) {
+      leds[ leds.rng.random16(leds.nrOfLeds) ] += CRGB::White;
     }
   }
 
@@ -157,9 +173,10 @@ class RainbowWithGlitterEffect: public Effect {
 
 // Best of both worlds from Palette and Spot effects. By Aircoookie
 class FlowEffect: public Effect {
-  const char * name() {return "Flow";}
-  uint8_t      dim()  {return _1D;}
-  const char * tags() {return "💡";} //💡 means wled origin
+public:
+  static constexpr const char *name = "Flow";
+  static constexpr uint8_t dim = _1D;
+  static constexpr const char *tags = "💡"; //💡 means wled origin
 
   void loop(Leds &leds) {
     // UI Variables
@@ -200,9 +217,10 @@ class FlowEffect: public Effect {
 
 // a colored dot sweeping back and forth, with fading trails
 class SinelonEffect: public Effect {
-  const char * name() {return "Sinelon";}
-  uint8_t dim() {return _1D;}
-  const char * tags() {return "⚡";}
+public:
+  static constexpr const char *name = "Sinelon";
+  static constexpr uint8_t dim = _1D;
+  static constexpr const char *tags = "⚡";
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
@@ -220,15 +238,16 @@ class SinelonEffect: public Effect {
 }; //Sinelon
 
 class ConfettiEffect: public Effect {
-  const char * name() {return "Confetti";}
-  uint8_t dim() {return _1D;}
-  const char * tags() {return "⚡";}
+public:
+  static constexpr const char *name = "Confetti";
+  static constexpr uint8_t dim = _1D;
+  static constexpr const char *tags = "⚡";
 
   void loop(Leds &leds) {
     // random colored speckles that blink in and fade smoothly
     leds.fadeToBlackBy(10);
-    int pos = random16(leds.nrOfLeds);
-    leds[pos] += CHSV( sys->now/50 + random8(64), 200, 255);
+    int pos = leds.rng.random16(leds.nrOfLeds);
+    leds[pos] += CHSV( sys->now/50 + leds.rng.random8(64), 200, 255);
   }
 
   void controls(Leds &leds, JsonObject parentVar) {} //so no palette control is created
@@ -236,9 +255,10 @@ class ConfettiEffect: public Effect {
 
 // colored stripes pulsing at a defined Beats-Per-Minute (BPM)
 class BPMEffect: public Effect {
-  const char * name() {return "Beats per minute";}
-  uint8_t dim() {return _1D;}
-  const char * tags() {return "⚡";}
+public:
+  static constexpr const char *name = "Beats per minute";
+  static constexpr uint8_t dim = _1D;
+  static constexpr const char *tags = "⚡";
 
   void loop(Leds &leds) {
     uint8_t BeatsPerMinute = 62;
@@ -255,9 +275,10 @@ class BPMEffect: public Effect {
 
 // eight colored dots, weaving in and out of sync with each other
 class JuggleEffect: public Effect {
-  const char * name() {return "Juggle";}
-  uint8_t dim() {return _1D;}
-  const char * tags() {return "⚡";}
+public:
+  static constexpr const char *name = "Juggle";
+  static constexpr uint8_t dim = _1D;
+  static constexpr const char *tags = "⚡";
 
   void loop(Leds &leds) {
     leds.fadeToBlackBy(20);
@@ -273,9 +294,10 @@ class JuggleEffect: public Effect {
 
 //https://www.perfectcircuit.com/signal/difference-between-waveforms
 class RunningEffect: public Effect {
-  const char * name() {return "Running";}
-  uint8_t dim() {return _1D;}
-  const char * tags() {return "💫";}
+public:
+  static constexpr const char *name = "Running";
+  static constexpr uint8_t dim = _1D;
+  static constexpr const char *tags = "💫";
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
@@ -311,20 +333,26 @@ class RingEffect: public Effect {
 };
 
 class RingRandomFlow: public RingEffect {
-  const char * name() {return "RingRandomFlow";}
-  uint8_t dim() {return _1D;}
-  const char * tags() {return "💫";}
+public:
+  static constexpr const char *name = "RingRandomFlow";
+  static constexpr uint8_t dim = _1D;
+  static constexpr const char *tags = "💫";
+  unsigned16 dataSize(Leds &leds) {return 16 + leds.nrOfLeds;}
 
   void loop(Leds &leds) {
     //binding of loop persistent values (pointers)
+    uint16_t *head = leds.effectData.readWrite<uint16_t>();
     uint8_t *hue = leds.effectData.readWrite<uint8_t>(leds.nrOfLeds); //array
 
-    hue[0] = random(0, 255);
+    if (!leds.nrOfLeds) return;
+
+    //hue is a ring buffer: instead of shifting all rings outward, move the head (the inner ring) back
+    *head = (*head + leds.nrOfLeds - 1) % leds.nrOfLeds;
+    hue[*head] = leds.rng.random16(0, 255);
+    uint16_t index = *head;
     for (int r = 0; r < leds.nrOfLeds; r++) {
-      setRing(leds, r, CHSV(hue[r], 255, 255));
-    }
-    for (int r = (leds.nrOfLeds - 1); r >= 1; r--) {
-      hue[r] = hue[(r - 1)]; // set this ruing based on the inner
+      setRing(leds, r, CHSV(hue[index], 255, 255));
+      if (++index == leds.nrOfLeds) index = 0;
     }
     // FastLED.delay(SPEED);
   }
@@ -342,9 +370,10 @@ struct Ball {
 };
 
 class BouncingBalls: public Effect {
-  const char * name() {return "Bouncing Balls";}
-  uint8_t dim() {return _1D;}
-  const char * tags() {return "💡";}
+public:
+  static constexpr const char *name = "Bouncing Balls";
+  static constexpr uint8_t dim = _1D;
+  static constexpr const char *tags = "💡";
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
@@ -379,7 +408,7 @@ class BouncingBalls: public Effect {
         balls[i].lastBounceTime = time;
 
         if (balls[i].impactVelocity < 0.015f) {
-          float impactVelocityStart = sqrtf(-2.0f * gravity) * random8(5,11)/10.0f; // randomize impact velocity
+          float impactVelocityStart = sqrtf(-2.0f * gravity) * leds.rng.random8(5,11)/10.0f; // randomize impact velocity
           balls[i].impactVelocity = impactVelocityStart;
         }
       } else if (balls[i].height > 1.0f) {
@@ -457,12 +486,12 @@ void mode_fireworks(Leds &leds, uint16_t *aux0, uint16_t *aux1, uint8_t speed, u
 
   if (addPixels) {                                                                             // WLEDSR
     for(uint16_t i=0; i<max(1, leds.nrOfLeds/20); i++) {
-      if(random8(my_intensity) == 0) {
-        uint16_t index = random(leds.nrOfLeds);
+      if(leds.rng.random8(my_intensity) == 0) {
+        uint16_t index = leds.rng.random16(leds.nrOfLeds);
         if (soundColor < 0)
-          leds.setPixelColor(index, ColorFromPalette(leds.palette, random8()));
+          leds.setPixelColor(index, ColorFromPalette(leds.palette, leds.rng.random8()));
         else
-          leds.setPixelColor(index, ColorFromPalette(leds.palette, soundColor + random8(24))); // WLEDSR
+          leds.setPixelColor(index, ColorFromPalette(leds.palette, soundColor + leds.rng.random8(24))); // WLEDSR
         *aux1 = *aux0;
         *aux0 = index;
       }
@@ -472,9 +501,10 @@ void mode_fireworks(Leds &leds, uint16_t *aux0, uint16_t *aux1, uint8_t speed, u
 }
 
 class RainEffect: public Effect {
-  const char * name() {return "Rain";}
-  uint8_t dim() {return _1D;}
-  const char * tags() {return "💡";}
+public:
+  static constexpr const char *name = "Rain";
+  static constexpr uint8_t dim = _1D;
+  static constexpr const char *tags = "💡";
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
@@ -536,9 +566,10 @@ struct Spark {
 
 #define maxNumDrops 6
 class DripEffect: public Effect {
-  const char * name() {return "Drip";}
-  uint8_t dim() {return _1D;}
-  const char * tags() {return "💡💫";}
+public:
+  static constexpr const char *name = "Drip";
+  static constexpr uint8_t dim = _1D;
+  static constexpr const char *tags = "💡💫";
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
@@ -563,7 +594,7 @@ class DripEffect: public Effect {
         drops[j].vel = 0;           // speed
         drops[j].col = sourcedrop;  // brightness
         drops[j].colIndex = 1;      // drop state (0 init, 1 forming, 2 falling, 5 bouncing)
-        drops[j].velX = (uint32_t)ColorFromPalette(leds.palette, random8()); // random color
+        drops[j].velX = (uint32_t)ColorFromPalette(leds.palette, leds.rng.random8()); // random color
       }
       CRGB dropColor = drops[j].velX;
 
@@ -574,7 +605,7 @@ class DripEffect: public Effect {
 
         drops[j].col += swell; // swelling
 
-        if (random16() <= drops[j].col * swell * swell / 10) {               // random drop
+        if (leds.rng.random16() <= drops[j].col * swell * swell / 10) {               // random drop
           drops[j].colIndex=2;               //fall
           drops[j].col=255;
         }
@@ -622,9 +653,10 @@ class DripEffect: public Effect {
 }; // DripEffect
 
 class HeartBeatEffect: public Effect {
-  const char * name() {return "HeartBeat";}
-  uint8_t dim() {return _1D;}
-  const char * tags() {return "💡💫♥";}
+public:
+  static constexpr const char *name = "HeartBeat";
+  static constexpr uint8_t dim = _1D;
+  static constexpr const char *tags = "💡💫♥";
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
@@ -667,9 +699,10 @@ class HeartBeatEffect: public Effect {
 }; // HeartBeatEffect
 
 class FreqMatrix: public Effect {
-  const char * name() {return "FreqMatrix";}
-  uint8_t dim() {return _1D;}
-  const char * tags() {return "♪💡";}
+public:
+  static constexpr const char *name = "FreqMatrix";
+  static constexpr uint8_t dim = _1D;
+  static constexpr const char *tags = "♪💡";
 
   void setup(Leds &leds) {
     leds.fadeToBlackBy(16);
@@ -732,9 +765,10 @@ class FreqMatrix: public Effect {
 #define NUM_COLORS       3 /* number of colors per segment */
 
 class PopCorn: public Effect {
-  const char * name() {return "PopCorn";}
-  uint8_t dim() {return _1D;}
-  const char * tags() {return "♪💡";}
+public:
+  static constexpr const char *name = "PopCorn";
+  static constexpr uint8_t dim = _1D;
+  static constexpr const char *tags = "♪💡";
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
@@ -762,23 +796,23 @@ class PopCorn: public Effect {
         if (useaudio) {
           if (  (wledAudioMod->sync.volumeSmth > 1.0f)                      // no pops in silence
               // &&((wledAudioMod->sync.samplePeak > 0) || (wledAudioMod->sync.volumeRaw > 128))  // try to pop at onsets (our peek detector still sucks)
-              &&(random8() < 4) )                        // stay somewhat random
+              &&(leds.rng.random8() < 4) )                        // stay somewhat random
             doPopCorn = true;
         } else {         
-          if (random8() < 2) doPopCorn = true; // default POP!!!
+          if (leds.rng.random8() < 2) doPopCorn = true; // default POP!!!
         }
         // WLEDMM end
 
         if (doPopCorn) { // POP!!!
           popcorn[i].pos = 0.01f;
 
-          uint16_t peakHeight = 128 + random8(128); //0-255
+          uint16_t peakHeight = 128 + leds.rng.random8(128); //0-255
           peakHeight = (peakHeight * (leds.nrOfLeds -1)) >> 8;
           popcorn[i].vel = sqrtf(-2.0f * gravity * peakHeight);
 
           // if (SEGMENT.palette)
           // {
-            popcorn[i].colIndex = random8();
+            popcorn[i].colIndex = leds.rng.random8();
           // } else {
           //   byte col = random8(0, NUM_COLORS);
           //   if (!SEGCOLOR(2) || !SEGCOLOR(col)) col = 0;
@@ -805,9 +839,10 @@ class PopCorn: public Effect {
 }; //PopCorn
 
 class NoiseMeter: public Effect {
-  const char * name() {return "NoiseMeter";}
-  uint8_t dim() {return _1D;}
-  const char * tags() {return "♪💡";}
+public:
+  static constexpr const char *name = "NoiseMeter";
+  static constexpr uint8_t dim = _1D;
+  static constexpr const char *tags = "♪💡";
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
@@ -842,9 +877,10 @@ class NoiseMeter: public Effect {
 }; //NoiseMeter
 
 class AudioRings: public RingEffect {
-  const char * name() {return "AudioRings";}
-  uint8_t dim() {return _1D;}
-  const char * tags() {return "♫💫";}
+public:
+  static constexpr const char *name = "AudioRings";
+  static constexpr uint8_t dim = _1D;
+  static constexpr const char *tags = "♫💫";
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
@@ -891,9 +927,10 @@ class AudioRings: public RingEffect {
 };
 
 class DJLight: public Effect {
-  const char * name() {return "DJLight";}
-  uint8_t dim() {return _1D;}
-  const char * tags() {return "♫💡";}
+public:
+  static constexpr const char *name = "DJLight";
+  static constexpr uint8_t dim = _1D;
+  static constexpr const char *tags = "♫💡";
 
   void setup(Leds &leds) {
     leds.fill_solid(CRGB::Black, true); //no blend
@@ -975,9 +1012,10 @@ class DJLight: public Effect {
 //==========
 
 class LinesEffect: public Effect {
-  const char * name() {return "Lines";}
-  uint8_t dim() {return _2D;}
-  const char * tags() {return "💫";}
+public:
+  static constexpr const char *name = "Lines";
+  static constexpr uint8_t dim = _2D;
+  static constexpr const char *tags = "💫";
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
@@ -986,18 +1024,13 @@ class LinesEffect: public Effect {
 
     leds.fadeToBlackBy(100);
 
-    Coord3D pos = {0,0,0};
+    CRGB color = CHSV( sys->now/50, 255, 255);
     if (vertical) {
-      pos.x = map(beat16( bpm), 0, UINT16_MAX, 0, leds.size.x ); //instead of call%width
-
-      for (pos.y = 0; pos.y <  leds.size.y; pos.y++) {
-        leds[pos] = CHSV( sys->now/50, 255, 255);
-      }
+      int x = map(beat16( bpm), 0, UINT16_MAX, 0, leds.size.x ); //instead of call%width
+      leds.drawLine(x, 0, x, leds.size.y - 1, color);
     } else {
-      pos.y = map(beat16( bpm), 0, UINT16_MAX, 0, leds.size.y ); //instead of call%height
-      for (pos.x = 0; pos.x <  leds.size.x; pos.x++) {
-        leds[pos] = CHSV( sys->now/50, 255, 255);
-      }
+      int y = map(beat16( bpm), 0, UINT16_MAX, 0, leds.size.y ); //instead of call%height
+      leds.drawLine(0, y, leds.size.x - 1, y, color);
     }
   }
 
@@ -1009,9 +1042,10 @@ class LinesEffect: public Effect {
 
 // By: Stepko https://editor.soulmatelights.com/gallery/1012 , Modified by: Andrew Tuline
 class BlackHole: public Effect {
-  const char * name() {return "BlackHole";}
-  uint8_t dim() {return _2D;}
-  const char * tags() {return "💡";}
+public:
+  static constexpr const char *name = "BlackHole";
+  static constexpr uint8_t dim = _2D;
+  static constexpr const char *tags = "💡";
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
@@ -1056,9 +1090,10 @@ class BlackHole: public Effect {
 
 // dna originally by by ldirko at https://pastebin.com/pCkkkzcs. Updated by Preyy. WLED conversion by Andrew Tuline.
 class DNA: public Effect {
-  const char * name() {return "DNA";}
-  uint8_t dim() {return _2D;}
-  const char * tags() {return "💡💫";}
+public:
+  static constexpr const char *name = "DNA";
+  static constexpr uint8_t dim = _2D;
+  static constexpr const char *tags = "💡💫";
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
@@ -1095,9 +1130,18 @@ uint8_t gamma8(uint8_t b) { //we do nothing with gamma for now
   return b;
 }
 class DistortionWaves: public Effect {
-  const char * name() {return "DistortionWaves";}
-  uint8_t dim() {return _2D;}
-  const char * tags() {return "💡";}
+public:
+  static constexpr const char *name = "DistortionWaves";
+  static constexpr uint8_t dim = _2D;
+  static constexpr const char *tags = "💡";
+
+  //per column (x) or row (y): the inner cos8 terms and the squared distances to the 3 centers, for r, g and b
+  struct AxisTerms {
+    uint8_t cos[3];
+    int32_t squared[3];
+  };
+
+  unsigned16 dataSize(Leds &leds) {return 64 + (leds.size.x + leds.size.y) * sizeof(AxisTerms);} //controls, xTerms and yTerms
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
@@ -1117,29 +1161,39 @@ class DistortionWaves: public Effect {
     uint16_t cx2 = beatsin8(17-speed,0,leds.size.x-1)*scale;
     uint16_t cy2 = beatsin8(14-speed,0,leds.size.y-1)*scale;
     
-    uint16_t xoffs = 0;
-    Coord3D pos = {0,0,0};
-    for (pos.x = 0; pos.x < leds.size.x; pos.x++) {
-      xoffs += scale;
-      uint16_t yoffs = 0;
+    //the inner cos8 terms and the squared distances to the centers only depend on x or on y: once per column and row
+    uint8_t *normalized = leds.geoNormalized();
+    AxisTerms *xTerms = leds.effectData.readWrite<AxisTerms>(leds.size.x); //array
+    AxisTerms *yTerms = leds.effectData.readWrite<AxisTerms>(leds.size.y); //array
+    if (!xTerms || !yTerms) return;
+    for (int x = 0; x < leds.size.x; x++) {
+      uint8_t phase = normalized[x];
+      int32_t xoffs = (x + 1) * scale;
+      xTerms[x] = {{cos8((phase+a )&255), cos8((phase-a2)&255), cos8((phase+a3)&255)}, {(xoffs - cx) * (xoffs - cx), (xoffs - cx1) * (xoffs - cx1), (xoffs - cx2) * (xoffs - cx2)}};
+    }
+    for (int y = 0; y < leds.size.y; y++) {
+      uint8_t phase = normalized[leds.size.x + y];
+      int32_t yoffs = (y + 1) * scale;
+      yTerms[y] = {{cos8((phase-a2)&255), cos8((phase+a3)&255), cos8((phase-a) &255)}, {(yoffs - cy) * (yoffs - cy), (yoffs - cy1) * (yoffs - cy1), (yoffs - cy2) * (yoffs - cy2)}};
+    }
 
-      for (pos.y = 0; pos.y < leds.size.y; pos.y++) {
-        yoffs += scale;
+    for (Coord3D pos: leds.pixelSubset()) { //all pixels or a part of them (renderMode)
+      AxisTerms &xt = xTerms[pos.x];
+      AxisTerms &yt = yTerms[pos.y];
 
-        byte rdistort = cos8((cos8(((pos.x<<3)+a )&255)+cos8(((pos.y<<3)-a2)&255)+a3   )&255)>>1; 
-        byte gdistort = cos8((cos8(((pos.x<<3)-a2)&255)+cos8(((pos.y<<3)+a3)&255)+a+32 )&255)>>1; 
-        byte bdistort = cos8((cos8(((pos.x<<3)+a3)&255)+cos8(((pos.y<<3)-a) &255)+a2+64)&255)>>1; 
+      byte rdistort = cos8((xt.cos[0]+yt.cos[0]+a3   )&255)>>1; 
+      byte gdistort = cos8((xt.cos[1]+yt.cos[1]+a+32 )&255)>>1; 
+      byte bdistort = cos8((xt.cos[2]+yt.cos[2]+a2+64)&255)>>1; 
 
-        byte valueR = rdistort+ w*  (a- ( ((xoffs - cx)  * (xoffs - cx)  + (yoffs - cy)  * (yoffs - cy))>>7  ));
-        byte valueG = gdistort+ w*  (a2-( ((xoffs - cx1) * (xoffs - cx1) + (yoffs - cy1) * (yoffs - cy1))>>7 ));
-        byte valueB = bdistort+ w*  (a3-( ((xoffs - cx2) * (xoffs - cx2) + (yoffs - cy2) * (yoffs - cy2))>>7 ));
+      byte valueR = rdistort+ w*  (a- ( (xt.squared[0] + yt.squared[0])>>7  ));
+      byte valueG = gdistort+ w*  (a2-( (xt.squared[1] + yt.squared[1])>>7 ));
+      byte valueB = bdistort+ w*  (a3-( (xt.squared[2] + yt.squared[2])>>7 ));
 
-        valueR = gamma8(cos8(valueR));
-        valueG = gamma8(cos8(valueG));
-        valueB = gamma8(cos8(valueB));
+      valueR = gamma8(cos8(valueR));
+      valueG = gamma8(cos8(valueG));
+      valueB = gamma8(cos8(valueB));
 
-        leds[pos] = CRGB(valueR, valueG, valueB);
-      }
+      leds[pos] = CRGB(valueR, valueG, valueB);
     }
   }
   
@@ -1152,14 +1206,10 @@ class DistortionWaves: public Effect {
 //Octopus inspired by WLED, Stepko and Sutaburosu and blazoncek 
 //Idea from https://www.youtube.com/watch?v=HsA-6KIbgto&ab_channel=GreatScott%21 (https://editor.soulmatelights.com/gallery/671-octopus)
 class Octopus: public Effect {
-  const char * name() {return "Octopus";}
-  uint8_t dim() {return _2D;}
-  const char * tags() {return "💡";}
-
-  struct Map_t {
-    uint8_t angle;
-    uint8_t radius;
-  };
+public:
+  static constexpr const char *name = "Octopus";
+  static constexpr uint8_t dim = _2D;
+  static constexpr const char *tags = "💡";
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
@@ -1168,53 +1218,24 @@ class Octopus: public Effect {
     uint8_t offsetY = leds.effectData.read<uint8_t>();
     uint8_t legs = leds.effectData.read<uint8_t>();
 
-    //binding of loop persistent values (pointers) tbd: aux0,1,step etc can be renamed to meaningful names
-    Map_t    *rMap = leds.effectData.readWrite<Map_t>(leds.size.x * leds.size.y); //array
-    uint8_t *offsX = leds.effectData.readWrite<uint8_t>();
-    uint8_t *offsY = leds.effectData.readWrite<uint8_t>();
-    uint16_t *aux0 = leds.effectData.readWrite<uint16_t>();
-    uint16_t *aux1 = leds.effectData.readWrite<uint16_t>();
+    //binding of loop persistent values (pointers)
     uint32_t *step = leds.effectData.readWrite<uint32_t>();
 
-    const uint8_t mapp = 180 / max(leds.size.x,leds.size.y);
-
-    Coord3D pos = {0,0,0};
-
-    // re-init if SEGMENT dimensions or offset changed
-    if (*aux0 != leds.size.x || *aux1 != leds.size.y || offsetX != *offsX || offsetY != *offsY) {
-      // *step = 0;
-      *aux0 = leds.size.x;
-      *aux1 = leds.size.y;
-      *offsX = offsetX;
-      *offsY = offsetY;
-      const uint8_t C_X = leds.size.x / 2 + (offsetX - 128)*leds.size.x/255;
-      const uint8_t C_Y = leds.size.y / 2 + (offsetY - 128)*leds.size.y/255;
-      for (pos.x = 0; pos.x < leds.size.x; pos.x++) {
-        for (pos.y = 0; pos.y < leds.size.y; pos.y++) {
-          uint16_t indexV = leds.XY(pos.x, pos.y);
-          if (indexV < leds.size.x * leds.size.y) { //excluding UINT16_MAX from XY if out of bounds due to projection
-            rMap[indexV].angle = 40.7436f * atan2f(pos.y - C_Y, pos.x - C_X); // avoid 128*atan2()/PI
-            rMap[indexV].radius = hypotf(pos.x - C_X, pos.y - C_Y) * mapp; //thanks Sutaburosu
-          }
-        }
-      }
-    }
+    //angle and radius per pixel, rebuilt by leds if size (remap) or offset changed
+    const uint8_t C_X = leds.size.x / 2 + (offsetX - 128)*leds.size.x/255;
+    const uint8_t C_Y = leds.size.y / 2 + (offsetY - 128)*leds.size.y/255;
+    GeoPolar *rMap = leds.geoPolar(C_X, C_Y);
 
     *step = sys->now * speed / 32 / 10;//mdl->getValue("realFps").as<int>();  // WLEDMM 40fps
 
-    for (pos.x = 0; pos.x < leds.size.x; pos.x++) {
-      for (pos.y = 0; pos.y < leds.size.y; pos.y++) {
-        uint16_t indexV = leds.XY(pos.x, pos.y);
-        if (indexV < leds.size.x * leds.size.y) { //excluding UINT16_MAX from XY if out of bounds due to projection
-          byte angle = rMap[indexV].angle;
-          byte radius = rMap[indexV].radius;
-          //CRGB c = CHSV(*step / 2 - radius, 255, sin8(sin8((angle * 4 - radius) / 4 + *step) + radius - *step * 2 + angle * (SEGMENT.custom3/3+1)));
-          uint16_t intensity = sin8(sin8((angle * 4 - radius) / 4 + *step/2) + radius - *step + angle * legs);
-          intensity = map(intensity*intensity, 0, UINT16_MAX, 0, 255); // add a bit of non-linearity for cleaner display
-          CRGB color = ColorFromPalette(leds.palette, *step / 2 - radius, intensity);
-          leds[pos] = color;
-        }
-      }
+    for (Coord3D pos: leds.pixelSubset()) { //all pixels or a part of them (renderMode)
+      byte angle = rMap[pos.x + pos.y * leds.size.x].angle;
+      byte radius = rMap[pos.x + pos.y * leds.size.x].radius;
+      //CRGB c = CHSV(*step / 2 - radius, 255, sin8(sin8((angle * 4 - radius) / 4 + *step) + radius - *step * 2 + angle * (SEGMENT.custom3/3+1)));
+      uint16_t intensity = sin8(sin8((angle * 4 - radius) / 4 + *step/2) + radius - *step + angle * legs);
+      intensity = map(intensity*intensity, 0, UINT16_MAX, 0, 255); // add a bit of non-linearity for cleaner display
+      CRGB color = ColorFromPalette(leds.palette, *step / 2 - radius, intensity);
+      leds[pos] = color;
     }
   }
   
@@ -1240,9 +1261,10 @@ class Octopus: public Effect {
 
 //Lissajous inspired by WLED, Andrew Tuline 
 class Lissajous: public Effect {
-  const char * name() {return "Lissajous";}
-  uint8_t dim() {return _2D;}
-  const char * tags() {return "💡";}
+public:
+  static constexpr const char *name = "Lissajous";
+  static constexpr uint8_t dim = _2D;
+  static constexpr const char *tags = "💡";
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
@@ -1298,9 +1320,10 @@ class Lissajous: public Effect {
 
 //Frizzles inspired by WLED, Stepko, Andrew Tuline, https://editor.soulmatelights.com/gallery/640-color-frizzles
 class Frizzles: public Effect {
-  const char * name() {return "Frizzles";}
-  uint8_t dim() {return _2D;}
-  const char * tags() {return "💡";}
+public:
+  static constexpr const char *name = "Frizzles";
+  static constexpr uint8_t dim = _2D;
+  static constexpr const char *tags = "💡";
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
@@ -1329,29 +1352,42 @@ class Frizzles: public Effect {
 }; // Frizzles
 
 class ScrollingText: public Effect {
-  const char * name() {return "Scrolling Text";}
-  uint8_t dim() {return _2D;}
-  const char * tags() {return "💫";}
+public:
+  static constexpr const char *name = "Scrolling Text";
+  static constexpr uint8_t dim = _2D;
+  static constexpr const char *tags = "💫";
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
+    bool *textChanged = leds.effectData.readWrite<bool>();
     uint8_t speed = leds.effectData.read<uint8_t>();
     uint8_t font = leds.effectData.read<uint8_t>();
-    const char * text = mdl->getValue("text"); //effectData to be implemented!
+    bool proportional = leds.effectData.read<bool>();
+
+    //rasterize only if text or font changed, each frame only the visible columns are drawn
+    if (*textChanged) {
+      *textChanged = false;
+      const char * text = mdl->getValue("text");
+      // text might be nullified by selecting other effects and if effect is selected, controls are run afterwards  
+      // tbd: this should be removed and fx.changeFUn (setEffect) must make sure this cannot happen!!
+      leds.rasterizeText(text?text:"", font, proportional);
+    }
 
-    // text might be nullified by selecting other effects and if effect is selected, controls are run afterwards  
-    // tbd: this should be removed and fx.changeFUn (setEffect) must make sure this cannot happen!!
-    if (text && strlen(text)>0) {
+    if (leds.textStrip.columns.size()) {
       leds.fadeToBlackBy();
-      leds.drawText(text, 0, 0, font, CRGB::Red, - (sys->now/25*speed/256)); //instead of call
+      leds.drawTextStrip((uint64_t)sys->now * speed / 6400 % leds.textStripWidth(), 0, CRGB::Red); //now/25*speed/256 without overflow
     }
 
   }
   
   void controls(Leds &leds, JsonObject parentVar) {
-    ui->initText(parentVar, "text", "StarLight"); //effectData to be implemented!
+    bool *textChanged = leds.effectData.write<bool>(true);
+    ui->initText(parentVar, "text", "StarLight", 1024, false, [textChanged](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onChange: {*textChanged = true; return true;}
+      default: return false;
+    }});
     ui->initSlider(parentVar, "speed", leds.effectData.write<uint8_t>(128));
-    ui->initSelect(parentVar, "font", leds.effectData.write<uint8_t>(0), false, [](JsonObject var, uint8_t rowNr, uint8_t funType) { switch (funType) { //varFun
+    ui->initSelect(parentVar, "font", leds.effectData.write<uint8_t>(0), false, [textChanged](JsonObject var, uint8_t rowNr, uint8_t funType) { switch (funType) { //varFun
       case onUI: {
         JsonArray options = ui->setOptions(var);
         options.add("4x6");
@@ -1361,27 +1397,31 @@ class ScrollingText: public Effect {
         options.add("7x9");
         return true;
       }
+      case onChange: {*textChanged = true; return true;}
+      default: return false;
+    }});
+    ui->initCheckBox(parentVar, "proportional", leds.effectData.write<bool>(true), false, [textChanged](JsonObject var, uint8_t rowNr, uint8_t funType) { switch (funType) { //varFun
+      case onChange: {*textChanged = true; return true;}
       default: return false;
     }});
   }
 }; //ScrollingText
 
 class Noise2D: public Effect {
-  const char * name() {return "Noise2D";}
-  uint8_t dim() {return _2D;}
-  const char * tags() {return "💡";}
+public:
+  static constexpr const char *name = "Noise2D";
+  static constexpr uint8_t dim = _2D;
+  static constexpr const char *tags = "💡";
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
     uint8_t speed = leds.effectData.read<uint8_t>();
     uint8_t scale = leds.effectData.read<uint8_t>();
 
-    for (int y = 0; y < leds.size.y; y++) {
-      for (int x = 0; x < leds.size.x; x++) {
-        uint8_t pixelHue8 = inoise8(x * scale, y * scale, sys->now / (16 - speed));
-        // leds.setPixelColor(leds.XY(x, y), ColorFromPalette(leds.palette, pixelHue8));
-        leds.setPixelColorPal(leds.XY(x, y), pixelHue8);
-      }
+    for (Coord3D pos: leds.pixelSubset()) { //all pixels or a part of them (renderMode)
+      uint8_t pixelHue8 = inoise8(pos.x * scale, pos.y * scale, sys->now / (16 - speed));
+      // leds.setPixelColor(leds.XY(pos.x, pos.y), ColorFromPalette(leds.palette, pixelHue8));
+      leds.setPixelColorPal(leds.XY(pos.x, pos.y), pixelHue8);
     }
   }
   
@@ -1438,18 +1478,20 @@ uint16_t lcm(uint16_t a, uint16_t b) {
 // Written by Ewoud Wijma in 2022, inspired by https://natureofcode.com/book/chapter-7-cellular-automata/ and https://github.com/DougHaber/nlife-color ,
 // Modified By: Brandon Butler in 2024
 class GameOfLife: public Effect {
-  const char * name() {return "GameOfLife";}
-  uint8_t dim() {return _3D;} //supports 3D but also 2D (1D as well?)
-  const char * tags() {return "💫";}
+public:
+  static constexpr const char *name = "GameOfLife";
+  static constexpr uint8_t dim = _3D; //supports 3D but also 2D (1D as well?)
+  static constexpr const char *tags = "💫";
+  unsigned16 dataSize(Leds &leds) {return 128 + 2 * ((leds.size.x * leds.size.y * leds.size.z + 7) / 8);} //controls, vars, cells and futureCells
 
   void placePentomino(Leds &leds, byte *futureCells, bool colorByAge) {
     byte pattern[5][2] = {{1, 0}, {0, 1}, {1, 1}, {2, 1}, {2, 2}}; // R-pentomino
-    if (!random8(5)) pattern[0][1] = 3; // 1/5 chance to use glider
-    CRGB color = ColorFromPalette(leds.palette, random8());
+    if (!leds.rng.random8(5)) pattern[0][1] = 3; // 1/5 chance to use glider
+    CRGB color = ColorFromPalette(leds.palette, leds.rng.random8());
     for (int attempts = 0; attempts < 100; attempts++) {
-      int x = random8(1, leds.size.x - 3);
-      int y = random8(1, leds.size.y - 5);
-      int z = random8(2) * (leds.size.z - 1);
+      int x = leds.rng.random8(1, leds.size.x - 3);
+      int y = leds.rng.random8(1, leds.size.y - 5);
+      int z = leds.rng.random8(2) * (leds.size.z - 1);
       bool canPlace = true;
       for (int i = 0; i < 5; i++) {
         int nx = x + pattern[i][0];
@@ -1499,7 +1541,7 @@ class GameOfLife: public Effect {
     byte     *futureCells      = leds.effectData.readWrite<byte>(dataSize);
 
     CRGB bgColor = CRGB(bgC.x, bgC.y, bgC.z);
-    CRGB color   = ColorFromPalette(leds.palette, random8()); // Used if all parents died
+    CRGB color   = ColorFromPalette(leds.palette, leds.rng.random8()); // Used if all parents died
 
     // Start New Game of Life
     if (*setup || (*generation == 0 && *step < sys->now)) {
@@ -1512,7 +1554,7 @@ class GameOfLife: public Effect {
       memset(cells, 0, dataSize);
       for (int x = 0; x < leds.size.x; x++) for (int y = 0; y < leds.size.y; y++) for (int z = 0; z < leds.size.z; z++){
         if (leds.projectionDimension == _3D && !leds.isMapped(leds.XYZUnprojected({x,y,z}))) continue;
-        if (random8(100) < lifeChance) {
+        if (leds.rng.random8(100) < lifeChance) {
           setBitValue(cells, leds.XYZUnprojected({x,y,z}), true);
           leds.setPixelColor({x,y,z}, bgColor, 0); // Color set in redraw loop
         }
@@ -1546,9 +1588,9 @@ class GameOfLife: public Effect {
         if (!leds.isMapped(cIndex)) continue;
         bool alive = getBitValue(cells, cIndex);
         CRGB cellColor = leds.getPixelColor(cLoc);
-        bool recolor = (paletteChanged || (alive && *generation == 1 && cellColor == bgColor && !random(16))); // Palette change or Initial Color
+        bool recolor = (paletteChanged || (alive && *generation == 1 && cellColor == bgColor && !leds.rng.random16(16))); // Palette change or Initial Color
         // Redraw alive if palette changed, spawn initial colors randomly, age alive cells while paused
-        if      (alive && recolor) leds.setPixelColor(cLoc, colorByAge ? CRGB::Green : ColorFromPalette(leds.palette, random8()), 0);
+        if      (alive && recolor) leds.setPixelColor(cLoc, colorByAge ? CRGB::Green : ColorFromPalette(leds.palette, leds.rng.random8()), 0);
         else if (alive && colorByAge && !*generation) leds.setPixelColor(cLoc, CRGB::Red, 248);    // Age alive cells while paused
         // Redraw dead if palette changed, blur paused game, fade on newgame
         if      (!alive && (paletteChanged || disablePause)) leds.setPixelColor(cLoc, bgColor, 0); // Remove blended dead cells
@@ -1630,8 +1672,8 @@ class GameOfLife: public Effect {
         // Reproduction
         setBitValue(futureCells, cIndex, true);
         CRGB randomParentColor = color; // Last seen color, overwrite if colors are found
-        if (colorCount) randomParentColor = nColors[random8(colorCount)];
-        if (random8(100) < mutation) randomParentColor = ColorFromPalette(leds.palette, random8());
+        if (colorCount) randomParentColor = nColors[leds.rng.random8(colorCount)];
+        if (leds.rng.random8(100) < mutation) randomParentColor = ColorFromPalette(leds.palette, leds.rng.random8());
         leds.setPixelColor(cPos, colorByAge ? CRGB::Green : randomParentColor, 0);
 
       }
@@ -1654,7 +1696,7 @@ class GameOfLife: public Effect {
 
     bool repetition = false;
     if (!aliveCount || crc == *oscillatorCRC || crc == *spaceshipCRC || crc == *cubeGliderCRC) repetition = true;
-    if ((repetition && infinite) || (infinite && !random8(50)) || (infinite && float(aliveCount)/(aliveCount + deadCount) < 0.05)) {
+    if ((repetition && infinite) || (infinite && !leds.rng.random8(50)) || (infinite && float(aliveCount)/(aliveCount + deadCount) < 0.05)) {
       placePentomino(leds, futureCells, colorByAge); // Place R-pentomino/Glider if infinite mode is enabled
       memcpy(cells, futureCells, dataSize);
       repetition = false;
@@ -1707,9 +1749,10 @@ class GameOfLife: public Effect {
 }; //GameOfLife
 
 class RubiksCube: public Effect {
-  const char * name() {return "Rubik's Cube";}
-  unsigned8     dim() {return _3D;}
-  const char * tags() {return "💫";}
+public:
+  static constexpr const char *name = "Rubik's Cube";
+  static constexpr uint8_t dim = _3D;
+  static constexpr const char *tags = "💫";
 
   struct Cube {
       uint8_t SIZE;
@@ -1895,13 +1938,13 @@ class RubiksCube: public Effect {
       uint8_t direction; // 0 or 1 (1 bit)
   };
 
-  Move createRandomMoveStruct(uint8_t cubeSize, uint8_t prevFace) {
+  Move createRandomMoveStruct(Leds &leds, uint8_t cubeSize, uint8_t prevFace) {
       Move move;
       do {
-        move.face = random(6);
+        move.face = leds.rng.random16(6);
       } while (move.face/2 == prevFace/2);
-      move.width     = random(cubeSize-2);
-      move.direction = random(2);
+      move.width     = leds.rng.random16(cubeSize-2);
+      move.direction = leds.rng.random16(2);
       return move;
   }
 
@@ -1941,16 +1984,16 @@ class RubiksCube: public Effect {
       *step = sys->now + 1000;
       *setup = false;
       cube->init(cubeSize);
-      uint8_t moveCount = cubeSize * 10 + random(20);
+      uint8_t moveCount = cubeSize * 10 + leds.rng.random16(20);
       // Randomly turn entire cube
       for (int x = 0; x < 3; x++) {
-        if (random(2)) cube->rotateRight(1, cubeSize);
-        if (random(2)) cube->rotateTop  (1, cubeSize);
-        if (random(2)) cube->rotateFront(1, cubeSize);
+        if (leds.rng.random16(2)) cube->rotateRight(1, cubeSize);
+        if (leds.rng.random16(2)) cube->rotateTop  (1, cubeSize);
+        if (leds.rng.random16(2)) cube->rotateFront(1, cubeSize);
       }
       // Generate scramble
       for (int i = 0; i < moveCount; i++) {
-        Move move = createRandomMoveStruct(cubeSize, *prevFaceMoved);
+        Move move = createRandomMoveStruct(leds, cubeSize, *prevFaceMoved);
         *prevFaceMoved = move.face;
         moveList[i] = packMove(move);
 
@@ -1964,7 +2007,7 @@ class RubiksCube: public Effect {
 
     if (!speed || sys->now - *step < 1000 / speed || sys->now < *step) return;
 
-    Move move = randomTurning ? createRandomMoveStruct(cubeSize, *prevFaceMoved) : unpackMove(moveList[*moveIndex]);
+    Move move = randomTurning ? createRandomMoveStruct(leds, cubeSize, *prevFaceMoved) : unpackMove(moveList[*moveIndex]);
 
     (cube->*rotateFuncs[move.face])(!move.direction, move.width + 1);
       
@@ -1995,117 +2038,17 @@ class RubiksCube: public Effect {
 };
 
 class ParticleTest: public Effect {
-  const char * name() {return "Particle Test";}
-  unsigned8     dim() {return _3D;}
-  const char * tags() {return "💫🧭";}
-  
-  struct Particle {
-    float x, y, z;
-    float vx, vy, vz;
-    CRGB color;
-
-    void update() {
-      x += vx;
-      y += vy;
-      z += vz;
-    }
-    void revert() {
-      x -= vx;
-      y -= vy;
-      z -= vz;
-    }
-
-    Coord3D toCoord3DRounded() {
-      return Coord3D({int(round(x)), int(round(y)), int(round(z))});
-    }
-
-    void updatePositionandDraw(Leds &leds, int particleIndex = 0, bool debugPrint = false) {
-      if (debugPrint) ppf("Particle %d: Pos: %f, %f, %f Velocity: %f, %f, %f\n", particleIndex, x, y, z, vx, vy, vz);
-
-      Coord3D prevPos = toCoord3DRounded();
-      if (debugPrint) ppf("     PrevPos: %d, %d, %d\n", prevPos.x, prevPos.y, prevPos.z);
-      
-      update();
-      Coord3D newPos = toCoord3DRounded();
-      if (debugPrint) ppf("     NewPos: %d, %d, %d\n", newPos.x, newPos.y, newPos.z);
-
-      if (newPos == prevPos) return; // Skip if no change in position
-
-      leds.setPixelColor(prevPos, CRGB::Black, 0); // Clear previous position
-
-      if (leds.isMapped(leds.XYZUnprojected(newPos)) && !newPos.isOutofBounds(leds.size) && leds.getPixelColor(newPos) == CRGB::Black) {
-        if (debugPrint) ppf("     New Pos was mapped and particle placed\n");
-        leds.setPixelColor(newPos, color, 0); // Set new position
-        return;
-      }
-      
-      // Particle is not mapped, find nearest mapped pixel
-      Coord3D nearestMapped = prevPos;                          // Set nearest to previous position
-      unsigned nearestDist = newPos.distanceSquared(prevPos);   // Set distance to previous position
-      int diff = 0;                                             // If distance the same check how many coordinates are different (larger is better)
-      bool changed = false;
-
-      if (debugPrint) ppf("     %d, %d, %d, Not Mapped! Nearest: %d, %d, %d dist: %d diff: %d\n", newPos.x, newPos.y, newPos.z, nearestMapped.x, nearestMapped.y, nearestMapped.z, nearestDist, diff);
-      
-      // Check neighbors for nearest mapped pixel. This should be changed to check neighbors with similar velocity
-      for (int i = -1; i <= 1; i++) for (int j = -1; j <= 1; j++) for (int k = -1; k <= 1; k++) {
-        Coord3D testPos = newPos + Coord3D({i, j, k});
-        if (testPos == prevPos)                         continue; // Skip current position
-        if (!leds.isMapped(leds.XYZUnprojected(testPos)))    continue; // Skip if not mapped
-        if (testPos.isOutofBounds(leds.size))           continue; // Skip out of bounds
-        if (leds.getPixelColor(testPos) != CRGB::Black) continue; // Skip if already colored by another particle
-        unsigned dist = testPos.distanceSquared(newPos);
-        int differences = (prevPos.x != testPos.x) + (prevPos.y != testPos.y) + (prevPos.z != testPos.z);
-        if (debugPrint) ppf ("     TestPos: %d %d %d Dist: %d Diff: %d", testPos.x, testPos.y, testPos.z, dist, differences);
-        if (debugPrint) ppf ("     New Velocities: %d, %d, %d\n", (testPos.x - prevPos.x), (testPos.y - prevPos.y), (testPos.z - prevPos.z));
-        if (dist < nearestDist || (dist == nearestDist && differences >= diff)) {
-          nearestDist = dist;
-          nearestMapped = testPos;
-          diff = differences;
-          changed = true;
-        }
-      }
-      if (changed) { // Change velocity to move towards nearest mapped pixel. Update position.
-        if (newPos.x != nearestMapped.x) vx = constrain(nearestMapped.x - prevPos.x, -1, 1);
-        if (newPos.y != nearestMapped.y) vy = constrain(nearestMapped.y - prevPos.y, -1, 1);
-        if (newPos.z != nearestMapped.z) vz = constrain(nearestMapped.z - prevPos.z, -1, 1);
-
-        x = nearestMapped.x; 
-        y = nearestMapped.y; 
-        z = nearestMapped.z;
-        
-        if (debugPrint) ppf("     New Position: %d, %d, %d New Velocity: %f, %f, %f\n", nearestMapped.x, nearestMapped.y, nearestMapped.z, vx, vy, vz);
-      }
-      else {
-        // No valid position found, revert to previous position
-        // Find which direction is causing OoB / not mapped and set velocity to 0
-        Coord3D testing = toCoord3DRounded();
-        revert();
-        // change X val
-        testing.x = newPos.x;
-        if (testing.isOutofBounds(leds.size) || !leds.isMapped(leds.XYZUnprojected(testing))) vx = 0;
-        // change Y val
-        testing = toCoord3DRounded();
-        testing.y = newPos.y;
-        if (testing.isOutofBounds(leds.size) || !leds.isMapped(leds.XYZUnprojected(testing))) vy = 0;
-        // change Z val
-        testing = toCoord3DRounded();
-        testing.z = newPos.z;
-        if (testing.isOutofBounds(leds.size) || !leds.isMapped(leds.XYZUnprojected(testing))) vz = 0;
-        
-        if (debugPrint) ppf("     No valid position found, reverted. Velocity Updated\n");
-        if (debugPrint) ppf("     New Pos: %f, %f, %f Velo: %f, %f, %f\n", x, y, z, vx, vy, vz);
-      }
-
-      leds.setPixelColor(toCoord3DRounded(), color, 0); // Set new position
-    }
-  };
+public:
+  static constexpr const char *name = "Particle Test";
+  static constexpr uint8_t dim = _3D;
+  static constexpr const char *tags = "💫🧭";
+  unsigned16 dataSize(Leds &leds) {return 32 + Particles::dataSize(100);} //default number of particles, more particles add a block
 
   void loop(Leds &leds) {
     // UI Variables
     bool   *setup        = leds.effectData.readWrite<bool>();
     uint8_t speed        = leds.effectData.read<uint8_t>();
-    uint8_t numParticles = leds.effectData.read<uint8_t>();
+    uint16_t numParticles = leds.effectData.read<uint16_t>();
     bool barriers        = leds.effectData.read<bool>();
     #ifdef STARBASE_USERMOD_MPU6050
       bool gyro = leds.effectData.read<bool>();
@@ -2114,67 +2057,48 @@ class ParticleTest: public Effect {
     #endif
     bool randomGravity = leds.effectData.read<bool>();
     uint8_t gravityChangeInterval = leds.effectData.read<uint8_t>();
-    // bool debugPrint    = leds.effectData.read<bool>();
-    bool debugPrint = false;
 
     // Effect Variables
-    Particle *particles       = leds.effectData.readWrite<Particle>(255);
     unsigned long *step       = leds.effectData.readWrite<unsigned long>();
     unsigned long *gravUpdate = leds.effectData.readWrite<unsigned long>();
-    float *gravity = leds.effectData.readWrite<float>(3);
+    Particles particles(leds.effectData, numParticles);
 
     if (*setup) {
       ppf("Setting Up Particles\n");
       *setup = false;
       leds.fill_solid(CRGB::Black, true);
+      particles.clear();
+      particles.addUnmapped(leds);
 
       if (barriers) {
         // create a 2 pixel thick barrier around middle y value with gaps
         for (int x = 0; x < leds.size.x; x++) for (int z = 0; z < leds.size.z; z++) {
-          if (!random8(5)) continue;
+          if (!leds.rng.random8(5)) continue;
+          particles.addBarrier(leds, {x, leds.size.y/2, z});
+          particles.addBarrier(leds, {x, leds.size.y/2 - 1, z});
           leds.setPixelColor({x, leds.size.y/2, z}, CRGB::White, 0);
           leds.setPixelColor({x, leds.size.y/2 - 1, z}, CRGB::White, 0);
         }
       }
 
-      for (int index = 0 ; index < numParticles; index++) {
-        Coord3D rPos; 
-        int attempts = 0; 
-        do { // Get random mapped position that isn't colored (infinite loop if small fixture size and high particle count)
-          rPos = {random8(leds.size.x), random8(leds.size.y), random8(leds.size.z)};
-          attempts++;
-        } while ((!leds.isMapped(leds.XYZUnprojected(rPos)) || leds.getPixelColor(rPos) != CRGB::Black) && attempts < 1000);
-        // rPos = {1,1,0};
-        particles[index].x = rPos.x;
-        particles[index].y = rPos.y;
-        particles[index].z = rPos.z;
-
-        particles[index].vx = (random8() / 256.0f) * 2.0f - 1.0f;
-        particles[index].vy = (random8() / 256.0f) * 2.0f - 1.0f;
-        if (leds.projectionDimension == _3D) particles[index].vz = (random8() / 256.0f) * 2.0f - 1.0f;
-        else particles[index].vz = 0;
-
-        particles[index].color = ColorFromPalette(leds.palette, random8());
-        Coord3D initPos = particles[index].toCoord3DRounded();
-        leds.setPixelColor(initPos, particles[index].color, 0);
-      }
-      ppf("Particles Set Up\n");
+      particles.scatter(leds, numParticles);
+      particles.render(leds);
+      ppf("Particles Set Up %d\n", *particles.count);
       *step = sys->now;
     }
 
     if (!speed || sys->now - *step < 1000 / speed) return; // Not enough time passed
 
-    float gravityX, gravityY, gravityZ; // Gravity if using gyro or random gravity
-
     #ifdef STARBASE_USERMOD_MPU6050
     if (gyro) {
-      gravity[0] = -mpu6050->gravityVector.x;
-      gravity[1] =  mpu6050->gravityVector.z; // Swap Y and Z axis
-      gravity[2] = -mpu6050->gravityVector.y;
+      // gravityVector is in g, scale to 1/4 pixel per step
+      particles.gravity[0] = -mpu6050->gravityVector.x * PARTICLE_ONE / 4;
+      particles.gravity[1] =  mpu6050->gravityVector.z * PARTICLE_ONE / 4; // Swap Y and Z axis
+      particles.gravity[2] = -mpu6050->gravityVector.y * PARTICLE_ONE / 4;
 
       if (leds.projectionDimension == _2D) { // Swap back Y and Z axis set Z to 0
-        gravity[1] = -gravity[2];
-        gravity[2] = 0;
+        particles.gravity[1] = -particles.gravity[2];
+        particles.gravity[2] = 0;
       }
     }
     #endif
@@ -2182,30 +2106,19 @@ class ParticleTest: public Effect {
     if (randomGravity) {
       if (sys->now - *gravUpdate > gravityChangeInterval * 1000) {
         *gravUpdate = sys->now;
-        float scale = 5.0f;
-        // Generate Perlin noise values and scale them
-        gravity[0] = (inoise8(*step, 0, 0) / 128.0f - 1.0f) * scale;
-        gravity[1] = (inoise8(0, *step, 0) / 128.0f - 1.0f) * scale;
-        gravity[2] = (inoise8(0, 0, *step) / 128.0f - 1.0f) * scale;
-
-        gravity[0] = constrain(gravity[0], -1.0f, 1.0f);
-        gravity[1] = constrain(gravity[1], -1.0f, 1.0f);
-        gravity[2] = constrain(gravity[2], -1.0f, 1.0f);
-
-        if (leds.projectionDimension == _2D) gravity[2] = 0;
-        // ppf("Random Gravity: %f, %f, %f\n", gravity[0], gravity[1], gravity[2]);
-      }
-    }
+        // Perlin noise values -128..127 scaled to -1/4..1/4 pixel per step
+        particles.gravity[0] = ((int16_t)inoise8(*step, 0, 0) - 128) * PARTICLE_ONE / 512;
+        particles.gravity[1] = ((int16_t)inoise8(0, *step, 0) - 128) * PARTICLE_ONE / 512;
+        particles.gravity[2] = ((int16_t)inoise8(0, 0, *step) - 128) * PARTICLE_ONE / 512;
 
-    for (int index = 0; index < numParticles; index++) {
-      if (gyro || randomGravity) { // Lerp gravity towards gyro or random gravity if enabled
-        float lerpFactor = .75;
-        particles[index].vx += (gravity[0] - particles[index].vx) * lerpFactor;
-        particles[index].vy += (gravity[1] - particles[index].vy) * lerpFactor; // Swap Y and Z axis
-        particles[index].vz += (gravity[2] - particles[index].vz) * lerpFactor;
+        if (leds.projectionDimension == _2D) particles.gravity[2] = 0;
       }
-      particles[index].updatePositionandDraw(leds, index, debugPrint);  
     }
+    else if (!gyro)
+      particles.gravity[0] = particles.gravity[1] = particles.gravity[2] = 0;
+
+    particles.step(leds);
+    particles.render(leds);
 
     *step = sys->now;
   }
@@ -2214,7 +2127,7 @@ class ParticleTest: public Effect {
     Effect::controls(leds, parentVar);
     bool *setup = leds.effectData.write<bool>(true);
     ui->initSlider  (parentVar, "Speed", leds.effectData.write<uint8_t>(1), 0, 30);
-    ui->initSlider  (parentVar, "Number of Particles", leds.effectData.write<uint8_t>(10), 1, 255, false, [setup] (JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) {
+    ui->initNumber  (parentVar, "Number of Particles", leds.effectData.write<uint16_t>(100), 1, PARTICLES_Max, false, [setup] (JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) {
       case onChange: {*setup = true; return true;}
       default: return false;
     }});
@@ -2227,7 +2140,6 @@ class ParticleTest: public Effect {
     #endif
     ui->initCheckBox(parentVar, "Random Gravity",          leds.effectData.write<bool>(1));
     ui->initSlider  (parentVar, "Gravity Change Interval", leds.effectData.write<uint8_t>(5), 1, 10);
-    // ui->initCheckBox(parentVar, "Debug Print",             leds.effectData.write<bool>(0));
   }
 };
 
@@ -2240,9 +2152,10 @@ class ParticleTest: public Effect {
 #ifdef STARLIGHT_USERMOD_WLEDAUDIO
 
 class Waverly: public Effect {
-  const char * name() {return "Waverly";}
-  uint8_t dim() {return _2D;}
-  const char * tags() {return "♪💡";}
+public:
+  static constexpr const char *name = "Waverly";
+  static constexpr uint8_t dim = _2D;
+  static constexpr const char *tags = "♪💡";
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
@@ -2284,9 +2197,11 @@ class Waverly: public Effect {
 }; //Waverly
 
 class GEQEffect: public Effect {
-  const char * name() {return "GEQ";}
-  uint8_t dim() {return _2D;}
-  const char * tags() {return "♫💡";}
+public:
+  static constexpr const char *name = "GEQ";
+  static constexpr uint8_t dim = _2D;
+  static constexpr const char *tags = "♫💡";
+  unsigned16 dataSize(Leds &leds) {return 32 + leds.size.x * sizeof(uint16_t);}
 
   void setup(Leds &leds) {
     leds.fadeToBlackBy(16);
@@ -2401,9 +2316,10 @@ class GEQEffect: public Effect {
 
 //by @Troy
 class LaserGEQEffect: public Effect {
-  const char * name() {return "laserGEQ";}
-  uint8_t dim() {return _2D;}
-  const char * tags() {return "♫💫";}
+public:
+  static constexpr const char *name = "laserGEQ";
+  static constexpr uint8_t dim = _2D;
+  static constexpr const char *tags = "♫💫";
 
   void setup(Leds &leds) {
     leds.fadeToBlackBy(16);
@@ -2444,16 +2360,15 @@ class LaserGEQEffect: public Effect {
 
       if (heights[i] > 1) {
 
+        //side of the bar to the projector: one triangle instead of a line per row
         if (linex < *projector) {
-          for (int y = 0; y <= heights[i]; y++) {
-            leds.drawLine(linex+(leds.size.x/16)-1,leds.size.y-y-1,*projector,0, blend(ledColor, CRGB::Black, 32));
-          } 
+          Coord3D side[3] = {{linex+(leds.size.x/16)-1, leds.size.y-1, 0}, {linex+(leds.size.x/16)-1, leds.size.y-heights[i]-1, 0}, {*projector, 0, 0}};
+          leds.fillPolygon(side, 3, blend(ledColor, CRGB::Black, 32));
         }
 
         if (linex > *projector) {
-          for (int y = 0; y <= heights[i]; y++) {
-            leds.drawLine(linex           ,leds.size.y-y-1,*projector,0, blend(ledColor, CRGB::Black, 32));
-          } 
+          Coord3D side[3] = {{linex, leds.size.y-1, 0}, {linex, leds.size.y-heights[i]-1, 0}, {*projector, 0, 0}};
+          leds.fillPolygon(side, 3, blend(ledColor, CRGB::Black, 32));
         }
 
       }
@@ -2469,16 +2384,15 @@ class LaserGEQEffect: public Effect {
 
       if (heights[i] > 1) {
 
+        //side of the bar to the projector: one triangle instead of a line per row
         if (linex < *projector) {
-          for (int y = 0; y <= heights[i]; y++) {
-            leds.drawLine(linex+(leds.size.x/16)-1,leds.size.y-y-1,*projector,0, blend(ledColor, CRGB::Black, 32));
-          } 
+          Coord3D side[3] = {{linex+(leds.size.x/16)-1, leds.size.y-1, 0}, {linex+(leds.size.x/16)-1, leds.size.y-heights[i]-1, 0}, {*projector, 0, 0}};
+          leds.fillPolygon(side, 3, blend(ledColor, CRGB::Black, 32));
         }
 
         if (linex > *projector) {
-          for (int y = 0; y <= heights[i]; y++) {
-            leds.drawLine(linex           ,leds.size.y-y-1,*projector,0, blend(ledColor, CRGB::Black, 32));
-          } 
+          Coord3D side[3] = {{linex, leds.size.y-1, 0}, {linex, leds.size.y-heights[i]-1, 0}, {*projector, 0, 0}};
+          leds.fillPolygon(side, 3, blend(ledColor, CRGB::Black, 32));
         }
       }
     }
@@ -2491,9 +2405,8 @@ class LaserGEQEffect: public Effect {
       int linex = i*(leds.size.x/16);
 
       if (heights[i] > 1) {
-        for (int x=linex; x<=linex+(leds.size.x/16)-1;x++) {
-          leds.drawLine(x,            leds.size.y-heights[i]-2,*projector,0, blend(ledColor, CRGB::Black, 128)); // top perspective
-        }
+        Coord3D top[3] = {{linex, leds.size.y-heights[i]-2, 0}, {linex+(leds.size.x/16)-1, leds.size.y-heights[i]-2, 0}, {*projector, 0, 0}};
+        leds.fillPolygon(top, 3, blend(ledColor, CRGB::Black, 128)); // top perspective
       }
 
     }
@@ -2506,9 +2419,8 @@ class LaserGEQEffect: public Effect {
       int linex = i*(leds.size.x/16);
 
       if (heights[i] > 1) {
-        for (int x=linex; x<=linex+(leds.size.x/16)-1;x++) {
-          leds.drawLine(x,            leds.size.y-heights[i]-2,*projector,0, blend(ledColor, CRGB::Black, 128)); // top perspective
-        }
+        Coord3D top[3] = {{linex, leds.size.y-heights[i]-2, 0}, {linex+(leds.size.x/16)-1, leds.size.y-heights[i]-2, 0}, {*projector, 0, 0}};
+        leds.fillPolygon(top, 3, blend(ledColor, CRGB::Black, 128)); // top perspective
       }
 
     }
@@ -2521,9 +2433,7 @@ class LaserGEQEffect: public Effect {
       int linex = i*(leds.size.x/16);
 
       if (heights[i] > 1) {
-        for (int x=linex+1; x<linex+(leds.size.x/16)-1;x++) { 
-          leds.drawLine(x,leds.size.y-2,x,leds.size.y-heights[i]-2, blend(ledColor, CRGB::Black, 32)); // front fill
-        }
+        leds.fillRect(linex+1, leds.size.y-heights[i]-2, (leds.size.x/16)-2, heights[i]+1, blend(ledColor, CRGB::Black, 32)); // front fill
         leds.drawLine(linex,            leds.size.y-1,linex,leds.size.y-heights[i]-1,ledColor); // left side
         leds.drawLine(linex+(leds.size.x/16)-1,leds.size.y-1,linex+(leds.size.x/16)-1,leds.size.y-heights[i]-1,ledColor); // right side
         leds.drawLine(linex,            leds.size.y-heights[i]-2,linex+(leds.size.x/16)-1,leds.size.y-heights[i]-2,ledColor); // top
@@ -2539,9 +2449,10 @@ class LaserGEQEffect: public Effect {
 }; //LaserGEQEffect
 
 class FunkyPlank: public Effect {
-  const char * name() {return "Funky Plank";}
-  uint8_t dim() {return _2D;}
-  const char * tags() {return "♫💡💫";}
+public:
+  static constexpr const char *name = "Funky Plank";
+  static constexpr uint8_t dim = _2D;
+  static constexpr const char *tags = "♫💡💫";
 
   void setup(Leds &leds) {
     leds.fill_solid(CRGB::Black, true); //no blend
@@ -2595,9 +2506,10 @@ class FunkyPlank: public Effect {
 //==========
 
 class RipplesEffect: public Effect {
-  const char * name() {return "Ripples";}
-  uint8_t dim() {return _3D;}
-  const char * tags() {return "💫";}
+public:
+  static constexpr const char *name = "Ripples";
+  static constexpr uint8_t dim = _3D;
+  static constexpr const char *tags = "💫";
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
@@ -2608,14 +2520,16 @@ class RipplesEffect: public Effect {
 
     leds.fill_solid(CRGB::Black);
 
+    uint32_t time_interval = sys->now/(100 - speed)/((256.0f-128.0f)/20.0f);
+
     Coord3D pos = {0,0,0};
     for (pos.z=0; pos.z<leds.size.z; pos.z++) {
       for (pos.x=0; pos.x<leds.size.x; pos.x++) {
+        //distance of the y of the previous column and z to 3.5,3.5: each column follows the previous one (not a fixed geometry, so not cached)
         float d = distance(3.5f, 3.5f, 0.0f, (float)pos.y, (float)pos.z, 0.0f) / 9.899495f * leds.size.y;
-        uint32_t time_interval = sys->now/(100 - speed)/((256.0f-128.0f)/20.0f);
         pos.y = floor(leds.size.y/2.0f + sinf(d/ripple_interval + time_interval) * leds.size.y/2.0f); //between 0 and leds.size.y
 
-        leds[pos] = CHSV( sys->now/50 + random8(64), 200, 255);// ColorFromPalette(leds.palette,call, bri);
+        leds[pos] = CHSV( sys->now/50 + leds.rng.random8(64), 200, 255);// ColorFromPalette(leds.palette,call, bri);
       }
     }
   }
@@ -2627,41 +2541,33 @@ class RipplesEffect: public Effect {
 };
 
 class SphereMoveEffect: public Effect {
-  const char * name() {return "SphereMove";}
-  uint8_t dim() {return _3D;}
-  const char * tags() {return "💫";}
+public:
+  static constexpr const char *name = "SphereMove";
+  static constexpr uint8_t dim = _3D;
+  static constexpr const char *tags = "💫";
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
     uint8_t speed = leds.effectData.read<uint8_t>();
+    bool soft = leds.effectData.read<bool>();
 
     leds.fill_solid(CRGB::Black);
 
     uint32_t time_interval = sys->now/(100 - speed)/((256.0f-128.0f)/20.0f);
 
-    Coord3D origin;
-    origin.x = 3.5f+sinf(time_interval)*2.5f;
-    origin.y = 3.5f+cosf(time_interval)*2.5f;
-    origin.z = 3.5f+cosf(time_interval)*2.0f;
+    float originX = 3.5f+sinf(time_interval)*2.5f;
+    float originY = 3.5f+cosf(time_interval)*2.5f;
+    float originZ = 3.5f+cosf(time_interval)*2.0f;
 
     float diameter = 2.0f+sinf(time_interval/3.0f);
 
-    Coord3D pos;
-    for (pos.x=0; pos.x<leds.size.x; pos.x++) {
-        for (pos.y=0; pos.y<leds.size.y; pos.y++) {
-            for (pos.z=0; pos.z<leds.size.z; pos.z++) {
-                uint16_t d = distance(pos.x, pos.y, pos.z, origin.x, origin.y, origin.z);
-
-                if (d>diameter && d<diameter+1) {
-                  leds[pos] = CHSV( sys->now/50 + random8(64), 200, 255);// ColorFromPalette(leds.palette,call, bri);
-                }
-            }
-        }
-    }
+    //shell between diameter and diameter+1, only the voxels in its bounding box are visited
+    leds.drawShell(originX, originY, originZ, diameter + 0.5f, 1.0f, CHSV( sys->now/50 + leds.rng.random8(64), 200, 255), soft);
   }
   
   void controls(Leds &leds, JsonObject parentVar) {
     ui->initSlider(parentVar, "speed", leds.effectData.write<uint8_t>(50), 0, 99);
+    ui->initCheckBox(parentVar, "soft", leds.effectData.write<bool>(false));
   }
 }; // SphereMove3DEffect
 
@@ -2677,9 +2583,9 @@ class SphereMoveEffect: public Effect {
 */
 class Praxis: public Effect {
 public:
-  const char * name() {return "Praxis";}
-  uint8_t dim() {return _2D;}
-  const char * tags() {return "🌌";}
+  static constexpr const char *name = "Praxis";
+  static constexpr uint8_t dim = _2D;
+  static constexpr const char *tags = "🌌";
 
   void setup(Leds &leds) {
     leds.fill_solid(CRGB::Black);
@@ -2817,9 +2723,10 @@ public:
     // #endif
   }
 class PixelMapEffect: public Effect {
-  const char * name() {return "PixelMap";}
-  uint8_t dim() {return _3D;}
-  const char * tags() {return "💫";}
+public:
+  static constexpr const char *name = "PixelMap";
+  static constexpr uint8_t dim = _3D;
+  static constexpr const char *tags = "💫";
 
   void loop(Leds &leds) {
     //Binding of controls. Keep before binding of vars and keep in same order as in controls()
@@ -2830,7 +2737,7 @@ class PixelMapEffect: public Effect {
     leds.fill_solid(CRGB::Black);
 
     Coord3D pos = {x, y, z};
-    leds[pos] = CHSV( sys->now/50 + random8(64), 255, 255);// ColorFromPalette(leds.palette,call, bri);
+    leds[pos] = CHSV( sys->now/50 + leds.rng.random8(64), 255, 255);// ColorFromPalette(leds.palette,call, bri);
   }
   
   void controls(Leds &leds, JsonObject parentVar) {
@@ -2839,3 +2746,58 @@ class PixelMapEffect: public Effect {
     ui->initSlider(parentVar, "z", leds.effectData.write<uint8_t>(0), 0, leds.size.z - 1);
   }
 }; // PixelMap
+
+//plays a recording (see Recorder) on the physical leds, frames are streamed from the file at their recorded time
+//  each layer has its own Player (in effectData), allocated when a recording is opened
+class PlaybackEffect: public Effect {
+public:
+  static constexpr const char *name = "Playback";
+  static constexpr uint8_t dim = _1D;
+  static constexpr const char *tags = "💫";
+
+  void loop(Leds &leds) {
+    //Binding of controls. Keep before binding of vars and keep in same order as in controls()
+    bool *fileChanged = leds.effectData.readWrite<bool>();
+    uint8_t fileNr = leds.effectData.read<uint8_t>();
+
+    //binding of loop persistent values (setup)
+    Player **player = leds.effectData.readWrite<Player *>();
+
+    //open in the loop, not in onChange, so the file is not switched while a frame is read
+    if (*fileChanged) {
+      *fileChanged = false;
+      delete *player; *player = nullptr;
+      char fileName[32] = "";
+      if (fileNr > 0 && files->seqNrToName(fileName, fileNr - 1, ".slr")) { //-1 as none is no file
+        *player = new Player();
+        if (!(*player)->open(fileName)) {delete *player; *player = nullptr;}
+      }
+    }
+
+    if (*player) {
+      (*player)->loop(leds.fixture->ledsP, leds.fixture->nrOfLeds, sys->now);
+      leds.fixture->playbackDecodeMicros = max(leds.fixture->playbackDecodeMicros, (*player)->decodeMicros);
+    }
+  }
+
+  void teardown(Leds &leds) {
+    leds.effectData.begin();
+    leds.effectData.read<bool>();
+    leds.effectData.read<uint8_t>();
+    Player **player = leds.effectData.readWrite<Player *>();
+    delete *player; *player = nullptr; //closes the file
+  }
+
+  void controls(Leds &leds, JsonObject parentVar) {
+    bool *fileChanged = leds.effectData.write<bool>(true);
+    ui->initSelect(parentVar, "recording", leds.effectData.write<uint8_t>(0), false, [fileChanged](JsonObject var, uint8_t rowNr, uint8_t funType) { switch (funType) { //varFun
+      case onUI: {
+        JsonArray options = ui->setOptions(var);
+        options.add("None");
+        files->dirToJson(options, true, ".slr"); //only recordings, alphabetically
+        return true; }
+      case onChange: {*fileChanged = true; return true;}
+      default: return false;
+    }});
+  }
+}; // PlaybackEffect
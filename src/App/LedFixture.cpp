@@ -44,6 +44,8 @@ void Fixture::projectAndMap() {
             }
         }
         leds->mappingTable.clear();
+        leds->firstIndexP = UINT16_MAX;
+        leds->lastIndexP = 0;
         // leds->effectData.reset(); //do not reset as want to save settings.
       }
       rowNr++;
@@ -110,6 +112,14 @@ void Fixture::projectAndMap() {
                 if (sizeAdjusted.y > 1) leds->projectionDimension++;
                 if (sizeAdjusted.z > 1) leds->projectionDimension++;
 
+                //render at lower resolution: renderScale^dimension physical pixels share one virtual pixel (nearest upscale by the mapping)
+                if (leds->renderScale > 1) {
+                  Coord3D scale = {sizeAdjusted.x > 1?leds->renderScale:1, sizeAdjusted.y > 1?leds->renderScale:1, sizeAdjusted.z > 1?leds->renderScale:1};
+                  pixelAdjusted /= scale;
+                  midPosAdjusted /= scale;
+                  sizeAdjusted = (sizeAdjusted + scale - Coord3D{1,1,1}) / scale; // round up
+                }
+
                 Projection *projection = nullptr;
                 if (leds->projectionNr < projections.size())
                   projection = projections[leds->projectionNr];
@@ -146,6 +156,9 @@ void Fixture::projectAndMap() {
                       }
                     }
 
+                    leds->firstIndexP = min(leds->firstIndexP, indexP);
+                    leds->lastIndexP = max(leds->lastIndexP, indexP);
+
                     if (leds->checkPalColorEffect()) // checkPalColorEffect: temp method until all effects have been converted to Palette / 2 byte mapping mode
                       leds->mappingTable[indexV].addIndexP2(*leds, indexP);
                     else
@@ -219,6 +232,8 @@ void Fixture::projectAndMap() {
             leds->size = fixSize;
             leds->nrOfLeds = nrOfLeds;
             nrOfPhysical = nrOfLeds;
+            leds->firstIndexP = 0;
+            leds->lastIndexP = nrOfLeds - 1;
 
           } else {
 
@@ -281,6 +296,8 @@ void Fixture::projectAndMap() {
 
           ppf("projectAndMap leds[%d].size = %d + m:(%d * %d) B\n", rowNr, sizeof(Leds), leds->mappingTable.size(), sizeof(PhysMap)); //44 -> 164
 
+          leds->onRemap();
+
           leds->doMap = false;
         } //leds->doMap
         rowNr++;
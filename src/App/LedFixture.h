@@ -14,6 +14,9 @@
 #include "../Sys/SysModModel.h" //for Coord3D
 
 #include "LedLeds.h"
+#include "LedRecorder.h"
+#include "LedInterpolator.h"
+#include "LedRegistry.h"
 
 #define NUM_LEDS_Max 8192
 
@@ -26,8 +29,8 @@ class Leds; //forward
 
 class Projection {
 public:
-  virtual const char * name() {return "noname";}
-  virtual const char * tags() {return "";}
+  static constexpr const char *name = "noname";
+  static constexpr const char *tags = "";
 
   virtual void setup(Leds &leds, Coord3D &sizeAdjusted, Coord3D &pixelAdjusted, Coord3D &midPosAdjusted, Coord3D &mapped, uint16_t &indexV) {}
   
@@ -42,6 +45,10 @@ class Fixture {
 public:
 
   CRGB ledsP[NUM_LEDS_Max];
+  CRGB *showP = nullptr; //if pipelined (see LedModEffects): copy of ledsP being sent by the show task
+
+  //the frame which is shown, for senders of the output (e.g. DDP, Art-Net)
+  CRGB *presentedP() {return showP?showP:ledsP;}
 
   // CRGB *leds = nullptr;
     // if (!leds)
@@ -52,7 +59,7 @@ public:
   // leds = (CRGB*)malloc(nrOfLeds * sizeof(CRGB));
   // leds = (CRGB*)reallocarray
 
-  std::vector<Projection *> projections;
+  Registry<Projection> projections; //filled by LedModEffects
 
   unsigned16 nrOfLeds = 64; //amount of physical leds
   unsigned8 fixtureNr = -1;
@@ -66,6 +73,10 @@ public:
   bool doAllocPins = false;
 
   unsigned8 globalBlend = 128;
+
+  Recorder recorder; //records ledsP frames, see LedModEffects
+  unsigned32 playbackDecodeMicros = 0; //slowest layer playing a recording, see PlaybackEffect
+  FrameInterpolator interpolator; //keyframes if the output fps is higher than the effects fps, see LedModEffects
   
   //load fixture json file, parse it and depending on the projection, create a mapping for it
   void projectAndMap();
@@ -0,0 +1,112 @@
+/*
+   @title     StarLight
+   @file      LedGovernor.h
+   @date      20240720
+   @repo      https://github.com/MoonModules/StarLight
+   @Authors   https://github.com/MoonModules/StarLight/commits/main
+   @Copyright © 2024 Github StarLight Commit Authors
+   @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+   @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+*/
+
+#pragma once
+
+//quality knobs in the order they are stepped down
+enum GovernorKnobs {
+  gov_Preview, //preview interval x2, x4
+  gov_Interlace, //render ½, ¼ of the pixels per frame (effects supporting it)
+  gov_Scale, //render scale 1:2, 1:4 (remaps the layers)
+  gov_Network, //DDP and Art-Net send every 2nd, 4th frame
+  gov_count // keep as last entry
+};
+
+#define GOVERNOR_MAX_LEVEL 2 //each knob: 0 full quality, 1 half, 2 quarter
+#define GOVERNOR_HEADROOM_SECONDS 3 //seconds with headroom before a knob is stepped up again
+
+//holds the frame time (render, show and network) within 1000000 / fps by stepping permitted knobs down when the budget is exceeded, and up again when there is headroom
+//  checked once per second, one step at a time, so a step can take effect before the next one
+//  a knob is only stepped up if the frame time expected at the higher level is under the step down threshold, so it does not oscillate
+class FrameGovernor {
+
+public:
+  bool permitted[gov_count] = {true, true, false, true}; //scale remaps the layers, so not by default
+  unsigned8 level[gov_count] = {0};
+  unsigned32 networkMicros = 0; //time the network senders spend in the current second
+  char lastChange[48] = "";
+
+  //times a network sender until the end of its scope (also on early returns)
+  struct NetworkTimer {
+    FrameGovernor &governor;
+    unsigned long start = micros();
+    ~NetworkTimer() {governor.networkMicros += micros() - start;}
+  };
+
+  //1, 2 or 4
+  unsigned8 divider(unsigned8 knob) {return 1 << level[knob];}
+
+  //network senders skip frames if the network knob is down
+  bool networkFrame(unsigned32 frameNr) {return frameNr % divider(gov_Network) == 0;}
+
+  //once per second: returns true if a knob changed
+  bool adjust(unsigned32 busyMicros, unsigned32 nrOfFrames, unsigned16 fps) {
+    unsigned32 budgetMicros = 1000000 / max(fps, (unsigned16)1);
+    unsigned32 frameMicros = (busyMicros + networkMicros) / max(nrOfFrames, (unsigned32)1);
+    networkMicros = 0;
+
+    if (frameMicros > budgetMicros * 9 / 10 || nrOfFrames < fps * 9 / 10) { //over budget, or frames dropped
+      headroomSeconds = 0;
+      for (forUnsigned8 knob = 0; knob < gov_count; knob++) {
+        if (permitted[knob] && level[knob] < GOVERNOR_MAX_LEVEL) {
+          downMicros[knob][level[knob]] = frameMicros;
+          level[knob]++;
+          log("down", knob, frameMicros, budgetMicros);
+          return true;
+        }
+      }
+    }
+    else if (frameMicros < budgetMicros * 6 / 10) { //headroom: restore the last knob stepped down first
+      if (++headroomSeconds >= GOVERNOR_HEADROOM_SECONDS) {
+        headroomSeconds = 0;
+        for (int knob = gov_count - 1; knob >= 0; knob--) {
+          if (level[knob] > 0) {
+            //expected at the higher level: the frame time before the step down, or at most double as the knob halves the work
+            unsigned32 expectedMicros = min(downMicros[knob][level[knob] - 1], frameMicros * 2);
+            if (expectedMicros > budgetMicros * 9 / 10) return false; //would step down again
+            level[knob]--;
+            log("up", knob, frameMicros, budgetMicros);
+            return true;
+          }
+        }
+      }
+    }
+    else
+      headroomSeconds = 0;
+    return false;
+  }
+
+  //back to full quality, returns true if a knob changed
+  bool reset() {
+    bool changed = false;
+    for (forUnsigned8 knob = 0; knob < gov_count; knob++) {
+      changed |= level[knob] > 0;
+      level[knob] = 0;
+    }
+    headroomSeconds = 0;
+    networkMicros = 0;
+    return changed;
+  }
+
+  static const char *knobName(unsigned8 knob) {
+    static const char *names[gov_count] = {"preview", "interlace", "scale", "network"};
+    return names[knob];
+  }
+
+private:
+  unsigned8 headroomSeconds = 0;
+  unsigned32 downMicros[gov_count][GOVERNOR_MAX_LEVEL] = {{0}}; //frame time measured before the knob was stepped down from each level
+
+  void log(const char *direction, unsigned8 knob, unsigned32 frameMicros, unsigned32 budgetMicros) {
+    snprintf(lastChange, sizeof(lastChange), "%s %s 1/%d (%u of %u µs)", knobName(knob), direction, divider(knob), frameMicros, budgetMicros);
+    ppf("Governor %s\n", lastChange);
+  }
+};
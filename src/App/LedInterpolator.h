@@ -0,0 +1,86 @@
+/*
+   @title     StarLight
+   @file      LedInterpolator.h
+   @date      20240720
+   @repo      https://github.com/MoonModules/StarLight
+   @Authors   https://github.com/MoonModules/StarLight/commits/main
+   @Copyright © 2024 Github StarLight Commit Authors
+   @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+   @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+*/
+
+#pragma once
+#include "LedPacer.h"
+
+//Output frames between the last two rendered frames (keyframes), so the leds can be sent at a higher rate than the effects compute
+//  the output is one compute frame behind: when a keyframe is added the previous one is shown, then blended towards the new one
+//  ledsP holds the blended output, restore() puts the last keyframe back before the effects render (they read their previous pixels)
+class FrameInterpolator {
+
+public:
+  unsigned32 blendMicros = 0; //average time to blend an output frame
+
+  bool isActive() {return !next.empty();}
+
+  //returns false if already begun with nrOfLeds, true if the keyframes are (re)allocated
+  bool begin(unsigned16 nrOfLeds) {
+    if (prev.size() == nrOfLeds) return false;
+    prev.assign(nrOfLeds, CRGB::Black);
+    next.assign(nrOfLeds, CRGB::Black);
+    keyMicros = 0;
+    blended = true; //nothing to blend until the first keyframe
+    ppf("Interpolator begin %d leds\n", nrOfLeds);
+    return true;
+  }
+
+  void end() {
+    if (!isActive()) return;
+    prev.clear(); prev.shrink_to_fit();
+    next.clear(); next.shrink_to_fit();
+    ppf("Interpolator end\n");
+  }
+
+  //before rendering: ledsP as the effects left it
+  void restore(CRGB *ledsP) {
+    memcpy(ledsP, next.data(), next.size() * sizeof(CRGB));
+  }
+
+  //after rendering: ledsP is the new keyframe, the previous one is written to ledsP to be shown
+  void addKeyframe(CRGB *ledsP, unsigned32 periodMicros) {
+    std::swap(prev, next);
+    memcpy(next.data(), ledsP, next.size() * sizeof(CRGB));
+    keyMicros = pacerMicros();
+    this->periodMicros = max(periodMicros, 1U);
+    memcpy(ledsP, prev.data(), prev.size() * sizeof(CRGB));
+    blended = false;
+  }
+
+  //between keyframes: blend prev and next in ledsP, returns false if there is nothing new to show (blend complete)
+  bool output(CRGB *ledsP) {
+    if (blended) return false;
+    int64_t startMicros = pacerMicros();
+    unsigned32 fraction = min((startMicros - keyMicros) * 256 / periodMicros, (int64_t)256); //0..256 in fixed point
+    if (fraction == 256) {
+      memcpy(ledsP, next.data(), next.size() * sizeof(CRGB));
+      blended = true;
+    }
+    else {
+      for (forUnsigned16 i = 0; i < next.size(); i++) {
+        //linear: prev + (next - prev) * fraction / 256 per channel
+        ledsP[i].r = prev[i].r + (((int)next[i].r - prev[i].r) * (int)fraction >> 8);
+        ledsP[i].g = prev[i].g + (((int)next[i].g - prev[i].g) * (int)fraction >> 8);
+        ledsP[i].b = prev[i].b + (((int)next[i].b - prev[i].b) * (int)fraction >> 8);
+      }
+    }
+    unsigned32 elapsed = pacerMicros() - startMicros;
+    blendMicros = blendMicros?(blendMicros * 7 + elapsed) / 8:elapsed;
+    return true;
+  }
+
+private:
+  std::vector<CRGB> prev;
+  std::vector<CRGB> next;
+  int64_t keyMicros = 0;
+  int64_t periodMicros = 1;
+  bool blended = true;
+};
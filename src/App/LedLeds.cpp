@@ -27,10 +27,52 @@ void fastled_fill_rainbow(struct CRGB * targetArray, int numToFill, unsigned8 in
 }
 
 void Leds::triggerMapping() {
+    applyFade(); //now, on the pixels of the current mapping
     doMap = true; //specify which leds to remap
     fixture->doMap = true; //fixture will also be remapped
   }
 
+void Leds::onRemap() {
+  geometry.clear(); //rebuilt with the new size when requested
+  geoNormalized(); //small (a byte per row, column and layer): always ready
+  endTransition(); //frames are for the previous physical pixels
+  staticHash = 0; //render the static effect on the new mapping
+}
+
+GeoPolar *Leds::geoPolar(float cx, float cy) {
+  if (cx < 0) cx = (size.x - 1) / 2.0f;
+  if (cy < 0) cy = (size.y - 1) / 2.0f;
+  unsigned32 nrOfPixels = size.x * size.y;
+  if (geometry.polar.size() != nrOfPixels || geometry.polarCenter[0] != cx || geometry.polarCenter[1] != cy) {
+    geometry.polar.resize(nrOfPixels);
+    geometry.polarCenter[0] = cx;
+    geometry.polarCenter[1] = cy;
+    const uint8_t mapp = 180 / max(size.x, size.y);
+    GeoPolar *polar = geometry.polar.data();
+    for (forUnsigned16 y = 0; y < size.y; y++) {
+      for (forUnsigned16 x = 0; x < size.x; x++) {
+        polar->angle = 40.7436f * atan2f(y - cy, x - cx); // avoid 128*atan2()/PI
+        polar->radius = hypotf(x - cx, y - cy) * mapp; //thanks Sutaburosu
+        polar++;
+      }
+    }
+    ppf("geoPolar built %d,%d c:%.1f,%.1f\n", size.x, size.y, cx, cy);
+  }
+  return geometry.polar.data();
+}
+
+uint8_t *Leds::geoNormalized() {
+  unsigned32 nrOfCoordinates = size.x + size.y + size.z;
+  if (geometry.normalized.size() != nrOfCoordinates) {
+    geometry.normalized.resize(nrOfCoordinates);
+    uint8_t *normalized = geometry.normalized.data();
+    for (forUnsigned16 x = 0; x < size.x; x++) *normalized++ = (x << 3) & 255;
+    for (forUnsigned16 y = 0; y < size.y; y++) *normalized++ = (y << 3) & 255;
+    for (forUnsigned16 z = 0; z < size.z; z++) *normalized++ = (z << 3) & 255;
+  }
+  return geometry.normalized.data();
+}
+
 unsigned16 Leds::XYZ(Coord3D pixel) {
 
   //as this is a call to a virtual function it reduces the theoretical (no show) speed by half, even if XYZ is not implemented
@@ -49,6 +91,7 @@ unsigned16 Leds::XYZ(Coord3D pixel) {
 
 // maps the virtual led to the physical led(s) and assign a color to it
 void Leds::setPixelColor(unsigned16 indexV, CRGB color, unsigned8 blendAmount) {
+  if (nrOfFadesPending) applyFade();
   if (indexV < mappingTable.size()) {
     switch (mappingTable[indexV].getMapType()) {
       case m_onePixel: {
@@ -66,12 +109,13 @@ void Leds::setPixelColor(unsigned16 indexV, CRGB color, unsigned8 blendAmount) {
     }
   }
   else if (indexV < NUM_LEDS_Max) //no projection
-    fixture->ledsP[(projectionNr == p_Random)?random(fixture->nrOfLeds):indexV] = color;
+    fixture->ledsP[(projectionNr == p_Random)?rng.random16(fixture->nrOfLeds):indexV] = color;
   else if (indexV != UINT16_MAX) //assuming UINT16_MAX is set explicitly (e.g. in XYZ)
     ppf(" dev sPC V:%d >= %d", indexV, NUM_LEDS_Max);
 }
 
 void Leds::setPixelColorPal(unsigned16 indexV, uint8_t palIndex, uint8_t palBri, unsigned8 blendAmount) {
+  if (nrOfFadesPending) applyFade();
   if (indexV < mappingTable.size()) {
     switch (mappingTable[indexV].mapType) {
       case m_color:
@@ -92,12 +136,13 @@ void Leds::setPixelColorPal(unsigned16 indexV, uint8_t palIndex, uint8_t palBri,
     }
   }
   else if (indexV < NUM_LEDS_Max) //no projection
-    fixture->ledsP[(projectionNr == p_Random)?random(fixture->nrOfLeds):indexV] = ColorFromPalette(palette, palIndex, palBri);
+    fixture->ledsP[(projectionNr == p_Random)?rng.random16(fixture->nrOfLeds):indexV] = ColorFromPalette(palette, palIndex, palBri);
   else if (indexV != UINT16_MAX) //assuming UINT16_MAX is set explicitly (e.g. in XYZ)
     ppf(" dev sPC V:%d >= %d", indexV, NUM_LEDS_Max);
 }
 
 CRGB Leds::getPixelColor(unsigned16 indexV) {
+  if (nrOfFadesPending) applyFade();
   if (indexV < mappingTable.size()) {
     switch (mappingTable[indexV].getMapType()) {
       case m_onePixel:
@@ -119,32 +164,96 @@ CRGB Leds::getPixelColor(unsigned16 indexV) {
   }
 }
 
-void Leds::fadeToBlackBy(unsigned8 fadeBy) {
-  if (projectionNr == p_None || projectionNr == p_Random || (fixture->listOfLeds.size() == 1)) {
-    fastled_fadeToBlackBy(fixture->ledsP, fixture->nrOfLeds, fadeBy);
+bool Leds::isFastPath() {
+  return projectionNr == p_None || projectionNr == p_Random || (fixture->listOfLeds.size() == 1);
+}
+
+//mapped layers: fades are applied one after the other per pixel, in one walk over the mapping table: same result as separate fadeToBlackBy passes
+//  (each physical pixel is in the mapping table once, see projectAndMap)
+//  define STARLIGHT_FADE_CHECK to compare each pass byte for byte with the separate passes (debug, slow)
+void Leds::applyFade() {
+  unsigned8 nrOfFades = nrOfFadesPending;
+  nrOfFadesPending = 0; //before the pass, so the pass itself does not trigger applyFade
+  if (nrOfFades == 0) return;
+
+  #ifdef STARLIGHT_FADE_CHECK
+    std::vector<CRGB> eager(fixture->ledsP, fixture->ledsP + fixture->nrOfLeds);
+    for (forUnsigned8 i = 0; i < nrOfFades; i++)
+      fadePass(eager.data(), fadePending[i]);
+  #endif
+
+  if (isFastPath()) {
+    for (forUnsigned8 i = 0; i < nrOfFades; i++) //no mapping table to walk: fastled's pass per fade is as fast as one pass doing all
+      fastled_fadeToBlackBy(fixture->ledsP, fixture->nrOfLeds, fadePending[i]);
+  } else {
+    for (PhysMap &map:mappingTable) {
+      switch (map.getMapType()) {
+        case m_onePixel:
+          fadePixel(map.indexP, nrOfFades);
+          break;
+        case m_morePixels:
+          for (forUnsigned16 indexP:*map.indexes)
+            fadePixel(indexP, nrOfFades);
+          break;
+      }
+    }
+  }
+
+  #ifdef STARLIGHT_FADE_CHECK
+    for (forUnsigned16 indexP = 0; indexP < fixture->nrOfLeds; indexP++) {
+      if (memcmp(&eager[indexP], &fixture->ledsP[indexP], sizeof(CRGB)) != 0) {
+        ppf("dev applyFade %d fades: led %d is %d,%d,%d, separate passes %d,%d,%d\n", nrOfFades, indexP, fixture->ledsP[indexP].r, fixture->ledsP[indexP].g, fixture->ledsP[indexP].b, eager[indexP].r, eager[indexP].g, eager[indexP].b);
+        break;
+      }
+    }
+  #endif
+}
+
+void Leds::fadePixel(unsigned16 indexP, unsigned8 nrOfFades) {
+  CRGB color = fixture->ledsP[indexP];
+  if (!color) return; //black stays black (most pixels of trail effects)
+  for (forUnsigned8 i = 0; i < nrOfFades; i++) {
+    CRGB oldValue = color;
+    color.nscale8(255-fadePending[i]); //this overrides the old value
+    if (fixture->globalBlend) color = blend(color, oldValue, fixture->globalBlend); // we want to blend in the old value (blend by 0 keeps color)
+  }
+  fixture->ledsP[indexP] = color;
+}
+
+#ifdef STARLIGHT_FADE_CHECK
+//one fadeToBlackBy pass as done before fades were deferred, on a copy of ledsP
+void Leds::fadePass(CRGB *buffer, unsigned8 fadeBy) {
+  if (isFastPath()) {
+    fastled_fadeToBlackBy(buffer, fixture->nrOfLeds, fadeBy);
   } else {
     for (PhysMap &map:mappingTable) {
       switch (map.getMapType()) {
         case m_onePixel: {
           uint16_t indexP = map.indexP;
-          CRGB oldValue = fixture->ledsP[indexP];
-          fixture->ledsP[indexP].nscale8(255-fadeBy); //this overrides the old value
-          fixture->ledsP[indexP] = blend(fixture->ledsP[indexP], oldValue, fixture->globalBlend); // we want to blend in the old value
+          CRGB oldValue = buffer[indexP];
+          buffer[indexP].nscale8(255-fadeBy); //this overrides the old value
+          buffer[indexP] = blend(buffer[indexP], oldValue, fixture->globalBlend); // we want to blend in the old value
           break; }
         case m_morePixels:
           for (forUnsigned16 indexP:*map.indexes) {
-            CRGB oldValue = fixture->ledsP[indexP];
-            fixture->ledsP[indexP].nscale8(255-fadeBy); //this overrides the old value
-            fixture->ledsP[indexP] = blend(fixture->ledsP[indexP], oldValue, fixture->globalBlend); // we want to blend in the old value
+            CRGB oldValue = buffer[indexP];
+            buffer[indexP].nscale8(255-fadeBy); //this overrides the old value
+            buffer[indexP] = blend(buffer[indexP], oldValue, fixture->globalBlend); // we want to blend in the old value
           }
           break;
       }
     }
   }
 }
+#endif
 
 void Leds::fill_solid(const struct CRGB& color, bool noBlend) {
-  if (projectionNr == p_None || projectionNr == p_Random || (fixture->listOfLeds.size() == 1)) {
+  if (isFastPath() || noBlend)
+    nrOfFadesPending = 0; //all pixels overwritten: no need to fade them first
+  else
+    applyFade();
+
+  if (isFastPath()) {
     fastled_fill_solid(fixture->ledsP, fixture->nrOfLeds, color);
   } else {
     for (PhysMap &map:mappingTable) {
@@ -164,7 +273,12 @@ void Leds::fill_solid(const struct CRGB& color, bool noBlend) {
 }
 
 void Leds::fill_rainbow(unsigned8 initialhue, unsigned8 deltahue) {
-  if (projectionNr == p_None || projectionNr == p_Random || (fixture->listOfLeds.size() == 1)) {
+  if (isFastPath())
+    nrOfFadesPending = 0; //all pixels overwritten: no need to fade them first
+  else
+    applyFade();
+
+  if (isFastPath()) {
     fastled_fill_rainbow(fixture->ledsP, fixture->nrOfLeds, initialhue, deltahue);
   } else {
     CHSV hsv;
@@ -189,6 +303,394 @@ void Leds::fill_rainbow(unsigned8 initialhue, unsigned8 deltahue) {
   }
 }
 
+void Leds::rasterizeText(const char * text, unsigned8 font, bool proportional) {
+  textStrip.clear();
+  Coord3D fontSize = fontSizeOf(font);
+  textStrip.height = fontSize.y;
+  textStrip.columns.reserve(strlen(text) * (fontSize.x + 1) + fontSize.x);
+
+  for (const char *chr = text; *chr; chr++) {
+    if (*chr < 32 || *chr > 126) continue; // only ASCII 32-126 supported
+
+    uint16_t glyph[8] = {0}; //columns of the character
+    byte used = 0; //columns with at least one pixel
+    for (forUnsigned8 row = 0; row < fontSize.y; row++) {
+      byte bits = fontRow(font, *chr, row);
+      used |= bits;
+      for (forUnsigned8 column = 0; column < fontSize.x; column++)
+        if ((bits >> (7 - column)) & 0x01) glyph[column] |= 1 << row;
+    }
+
+    if (!proportional)
+      textStrip.columns.insert(textStrip.columns.end(), glyph, glyph + fontSize.x);
+    else if (!used) //space
+      textStrip.columns.insert(textStrip.columns.end(), fontSize.x / 2 + 1, 0);
+    else {
+      unsigned8 first = 0, last = fontSize.x - 1;
+      while (!((used >> (7 - first)) & 0x01)) first++;
+      while (!((used >> (7 - last)) & 0x01)) last--;
+      textStrip.columns.insert(textStrip.columns.end(), glyph + first, glyph + last + 1);
+      textStrip.columns.push_back(0); //spacing
+    }
+  }
+  if (textStrip.columns.size())
+    textStrip.columns.insert(textStrip.columns.end(), fontSize.x, 0); //gap before the text repeats
+
+  ppf("rasterizeText %d chars -> %d columns\n", strlen(text), textStrip.columns.size());
+}
+
+unsigned16 Leds::textStripWidth() {
+  //text shorter than the layer: blank columns after the text
+  return max((unsigned16)textStrip.columns.size(), (unsigned16)size.x);
+}
+
+void Leds::drawTextStrip(unsigned16 offset, int16_t y, CRGB col) {
+  if (textStrip.columns.empty()) return;
+  unsigned16 length = textStripWidth();
+  offset %= length;
+  //per row, runs of set bits in the visible columns are drawn as one span
+  int rowEnd = min(y + textStrip.height, size.y);
+  for (int row = max((int)y, 0); row < rowEnd; row++) {
+    uint16_t bit = 1 << (row - y);
+    unsigned16 column = offset;
+    int spanStart = -1;
+    for (int x = 0; x < size.x; x++) {
+      bool on = column < textStrip.columns.size() && (textStrip.columns[column] & bit);
+      if (on && spanStart < 0) spanStart = x;
+      else if (!on && spanStart >= 0) {
+        drawSpan(spanStart, x - 1, row, col);
+        spanStart = -1;
+      }
+      if (++column == length) column = 0;
+    }
+    if (spanStart >= 0) drawSpan(spanStart, size.x - 1, row, col);
+  }
+}
+
+void Leds::drawSpan(int x0, int x1, int y, CRGB color, unsigned8 blendAmount, int z) {
+  if (x0 > x1) std::swap(x0, x1);
+  if (y < 0 || y >= size.y || z < 0 || z >= size.z || x1 < 0 || x0 >= size.x) return;
+  x0 = max(x0, 0);
+  x1 = min(x1, size.x - 1);
+  if (projectionNr == p_TiltPanRoll || projectionNr == p_Preset1) { //adjustXYZ moves pixels: each pixel through XYZ
+    for (int x = x0; x <= x1; x++) setPixelColor({x, y, z}, color, blendAmount);
+  }
+  else {
+    unsigned16 indexV = XYZUnprojected({x0, y, z});
+    for (int x = x0; x <= x1; x++) setPixelColor(indexV++, color, blendAmount);
+  }
+}
+
+//Cohen-Sutherland: clips the line to width x height, returns false if nothing is left
+static bool clipLine(int &x0, int &y0, int &x1, int &y1, int width, int height) {
+  auto outCode = [width, height](int x, int y) {return (x < 0) | ((x >= width) << 1) | ((y < 0) << 2) | ((y >= height) << 3);};
+  int code0 = outCode(x0, y0), code1 = outCode(x1, y1);
+  while (code0 | code1) {
+    if (code0 & code1) return false; //both on the same outside
+    int code = code0?code0:code1;
+    int x, y;
+    if (code & 8)      {x = x0 + (x1 - x0) * (height - 1 - y0) / (y1 - y0); y = height - 1;}
+    else if (code & 4) {x = x0 + (x1 - x0) * (0 - y0) / (y1 - y0);          y = 0;}
+    else if (code & 2) {y = y0 + (y1 - y0) * (width - 1 - x0) / (x1 - x0);  x = width - 1;}
+    else               {y = y0 + (y1 - y0) * (0 - x0) / (x1 - x0);          x = 0;}
+    if (code == code0) {x0 = x; y0 = y; code0 = outCode(x0, y0);}
+    else               {x1 = x; y1 = y; code1 = outCode(x1, y1);}
+  }
+  return true;
+}
+
+void Leds::drawLine(int x0, int y0, int x1, int y1, CRGB color, bool soft) {
+  if (!clipLine(x0, y0, x1, y1, size.x, size.y)) return;
+
+  if (soft && x0 != x1 && y0 != y1) { //Wu: per step two pixels, coverage as blend amount
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) {std::swap(x0, y0); std::swap(x1, y1);}
+    if (x0 > x1) {std::swap(x0, x1); std::swap(y0, y1);}
+    int32_t gradient = ((int32_t)(y1 - y0) << 16) / (x1 - x0); //16.16 fixed point
+    int32_t y = (int32_t)y0 << 16;
+    for (int x = x0; x <= x1; x++, y += gradient) {
+      int yi = y >> 16;
+      unsigned8 frac = (y >> 8) & 0xFF;
+      //blendAmount is the share of the old pixel kept (capped at 254, UINT8_MAX means globalBlend)
+      setPixelColor(steep?Coord3D{yi, x, 0}:Coord3D{x, yi, 0}, color, min(frac, (unsigned8)254));
+      if (frac) setPixelColor(steep?Coord3D{yi + 1, x, 0}:Coord3D{x, yi + 1, 0}, color, min((unsigned8)(255 - frac), (unsigned8)254));
+    }
+    return;
+  }
+
+  //Bresenham, pixels on the same row collected in one span
+  const int dx = abs(x1-x0), sx = x0<x1 ? 1 : -1;
+  const int dy = abs(y1-y0), sy = y0<y1 ? 1 : -1;
+  int err = (dx>dy ? dx : -dy)/2, e2;
+  int spanStart = x0;
+  while (x0 != x1 || y0 != y1) {
+    e2 = err;
+    int nextX = x0, nextY = y0;
+    if (e2 >-dx) { err -= dy; nextX += sx; }
+    if (e2 < dy) { err += dx; nextY += sy; }
+    if (nextY != y0) {
+      drawSpan(spanStart, x0, y0, color);
+      spanStart = nextX;
+    }
+    x0 = nextX; y0 = nextY;
+  }
+  drawSpan(spanStart, x0, y0, color);
+}
+
+void Leds::drawThickLine(int x0, int y0, int x1, int y1, unsigned8 thickness, CRGB color) {
+  if (thickness <= 1 || (x0 == x1 && y0 == y1)) {drawLine(x0, y0, x1, y1, color); return;}
+  //the line as a quad: endpoints moved perpendicular by half the thickness
+  float length = hypotf(x1 - x0, y1 - y0);
+  int ox = roundf(-(y1 - y0) * thickness / 2.0f / length);
+  int oy = roundf( (x1 - x0) * thickness / 2.0f / length);
+  Coord3D quad[4] = {{x0 + ox, y0 + oy, 0}, {x1 + ox, y1 + oy, 0}, {x1 - ox, y1 - oy, 0}, {x0 - ox, y0 - oy, 0}};
+  fillPolygon(quad, 4, color);
+}
+
+void Leds::drawCircle(int cx, int cy, int radius, CRGB color, bool filled) {
+  if (radius < 0 || cx + radius < 0 || cx - radius >= size.x || cy + radius < 0 || cy - radius >= size.y) return;
+
+  if (filled) { //one span per row, only the visible rows
+    int yEnd = min(cy + radius, size.y - 1);
+    for (int y = max(cy - radius, 0); y <= yEnd; y++) {
+      int halfWidth = sqrtf(radius * radius - (y - cy) * (y - cy)) + 0.5f;
+      drawSpan(cx - halfWidth, cx + halfWidth, y, color);
+    }
+    return;
+  }
+
+  //midpoint circle, pixels outside the layer are skipped by XYZ
+  int x = radius, y = 0, err = 1 - radius;
+  while (x >= y) {
+    setPixelColor({cx + x, cy + y, 0}, color); setPixelColor({cx - x, cy + y, 0}, color);
+    setPixelColor({cx + x, cy - y, 0}, color); setPixelColor({cx - x, cy - y, 0}, color);
+    setPixelColor({cx + y, cy + x, 0}, color); setPixelColor({cx - y, cy + x, 0}, color);
+    setPixelColor({cx + y, cy - x, 0}, color); setPixelColor({cx - y, cy - x, 0}, color);
+    y++;
+    if (err < 0) err += 2 * y + 1;
+    else {x--; err += 2 * (y - x) + 1;}
+  }
+}
+
+void Leds::fillRect(int x, int y, int width, int height, CRGB color) {
+  int yEnd = min(y + height, size.y);
+  for (int row = max(y, 0); row < yEnd; row++)
+    drawSpan(x, x + width - 1, row, color);
+}
+
+void Leds::fillPolygon(const Coord3D *points, unsigned8 nrOfPoints, CRGB color) {
+  if (nrOfPoints < 3) {
+    if (nrOfPoints == 2) drawLine(points[0].x, points[0].y, points[1].x, points[1].y, color);
+    return;
+  }
+  int yStart = points[0].y, yEnd = points[0].y;
+  for (forUnsigned8 i = 1; i < nrOfPoints; i++) {
+    yStart = min(yStart, points[i].y);
+    yEnd = max(yEnd, points[i].y);
+  }
+  yStart = max(yStart, 0);
+  yEnd = min(yEnd, size.y - 1);
+
+  //convex: each row is one span between the leftmost and rightmost edge crossing
+  for (int y = yStart; y <= yEnd; y++) {
+    int left = INT_MAX, right = INT_MIN;
+    for (forUnsigned8 i = 0; i < nrOfPoints; i++) {
+      const Coord3D &a = points[i];
+      const Coord3D &b = points[(i + 1) % nrOfPoints];
+      if ((y < a.y && y < b.y) || (y > a.y && y > b.y)) continue; //edge not on this row
+      if (a.y == b.y) {
+        left = min(left, min(a.x, b.x));
+        right = max(right, max(a.x, b.x));
+      }
+      else {
+        int x = a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y);
+        left = min(left, x);
+        right = max(right, x);
+      }
+    }
+    if (left <= right) drawSpan(left, right, y, color);
+  }
+}
+
+void Leds::drawSphere(float cx, float cy, float cz, float radius, CRGB color, bool soft) {
+  drawShell(cx, cy, cz, radius / 2, radius, color, soft); //a shell without hole
+}
+
+void Leds::drawShell(float cx, float cy, float cz, float radius, float thickness, CRGB color, bool soft) {
+  float edge = soft?0.5f:0; //soft: include voxels partly covered
+  float outer = radius + thickness / 2 + edge;
+  float inner = radius - thickness / 2 - edge;
+  float inner2 = inner > 0?inner * inner:-1;
+
+  //bounding box
+  int zEnd = min((int)floorf(cz + outer), size.z - 1);
+  int yEnd = min((int)floorf(cy + outer), size.y - 1);
+  for (int z = max((int)ceilf(cz - outer), 0); z <= zEnd; z++) {
+    for (int y = max((int)ceilf(cy - outer), 0); y <= yEnd; y++) {
+      float yz2 = (y - cy) * (y - cy) + (z - cz) * (z - cz);
+      if (yz2 > outer * outer) continue;
+
+      //the row crosses the shell in [cx - outerHalf, cx + outerHalf], minus the hole [cx - innerHalf, cx + innerHalf]
+      float outerHalf = sqrtf(outer * outer - yz2);
+      float innerHalf = (yz2 < inner2)?sqrtf(inner2 - yz2):-1;
+      int xEnd = min((int)floorf(cx + outerHalf), size.x - 1);
+      for (int x = max((int)ceilf(cx - outerHalf), 0); x <= xEnd; x++) {
+        if (innerHalf >= 0 && fabsf(x - cx) < innerHalf) { //jump over the hole
+          x = (int)ceilf(cx + innerHalf) - 1;
+          continue;
+        }
+        if (soft) {
+          float distance = sqrtf((x - cx) * (x - cx) + yz2);
+          float coverage = constrain(0.5f - (fabsf(distance - radius) - thickness / 2), 0.0f, 1.0f);
+          if (coverage > 0) setPixelColor({x, y, z}, color, (1 - coverage) * 254); //blendAmount: share of the old pixel kept
+        }
+        else
+          setPixelColor({x, y, z}, color);
+      }
+    }
+  }
+}
+
+void Leds::drawPlane(float nx, float ny, float nz, float offset, float thickness, CRGB color, bool soft) {
+  float length = sqrtf(nx * nx + ny * ny + nz * nz);
+  if (length == 0) return;
+  float normal[3] = {nx / length, ny / length, nz / length};
+  offset /= length;
+  float half = thickness / 2 + (soft?0.5f:0);
+
+  //walk the two axes the plane spans most, solve the third (dominant) axis: only voxels near the plane are visited
+  int sizes[3] = {size.x, size.y, size.z};
+  unsigned8 a = 0; //dominant axis
+  for (forUnsigned8 i = 1; i < 3; i++) if (fabsf(normal[i]) > fabsf(normal[a])) a = i;
+  unsigned8 u = (a + 1) % 3, v = (a + 2) % 3;
+
+  int voxel[3];
+  for (voxel[v] = 0; voxel[v] < sizes[v]; voxel[v]++) {
+    for (voxel[u] = 0; voxel[u] < sizes[u]; voxel[u]++) {
+      float centerA = (offset - normal[u] * voxel[u] - normal[v] * voxel[v]) / normal[a];
+      float halfA = half / fabsf(normal[a]);
+      int aEnd = min((int)floorf(centerA + halfA), sizes[a] - 1);
+      for (voxel[a] = max((int)ceilf(centerA - halfA), 0); voxel[a] <= aEnd; voxel[a]++) {
+        if (soft) {
+          float distance = fabsf(normal[0] * voxel[0] + normal[1] * voxel[1] + normal[2] * voxel[2] - offset);
+          float coverage = constrain(0.5f - (distance - thickness / 2), 0.0f, 1.0f);
+          if (coverage > 0) setPixelColor({voxel[0], voxel[1], voxel[2]}, color, (1 - coverage) * 254);
+        }
+        else
+          setPixelColor({voxel[0], voxel[1], voxel[2]}, color);
+      }
+    }
+  }
+}
+
+void Leds::drawBox(Coord3D from, Coord3D to, CRGB color) {
+  if (from.x > to.x) std::swap(from.x, to.x);
+  if (from.y > to.y) std::swap(from.y, to.y);
+  if (from.z > to.z) std::swap(from.z, to.z);
+  int zEnd = min(to.z, size.z - 1), yEnd = min(to.y, size.y - 1);
+  for (int z = max(from.z, 0); z <= zEnd; z++)
+    for (int y = max(from.y, 0); y <= yEnd; y++)
+      drawSpan(from.x, to.x, y, color, UINT8_MAX, z);
+}
+
+void Leds::drawLine3D(Coord3D from, Coord3D to, CRGB color) {
+  //culled if both ends are on the same outside of the layer
+  if ((from.x < 0 && to.x < 0) || (from.x >= size.x && to.x >= size.x) ||
+      (from.y < 0 && to.y < 0) || (from.y >= size.y && to.y >= size.y) ||
+      (from.z < 0 && to.z < 0) || (from.z >= size.z && to.z >= size.z)) return;
+
+  //3D Bresenham on the dominant axis, voxels outside the layer are skipped by XYZ
+  Coord3D delta = {abs(to.x - from.x), abs(to.y - from.y), abs(to.z - from.z)};
+  Coord3D step = {from.x < to.x?1:-1, from.y < to.y?1:-1, from.z < to.z?1:-1};
+  int steps = max(delta.x, max(delta.y, delta.z));
+  Coord3D err = {steps / 2, steps / 2, steps / 2};
+  Coord3D pixel = from;
+  for (int i = 0; i <= steps; i++) {
+    setPixelColor(pixel, color);
+    err.x -= delta.x; if (err.x < 0) {err.x += steps; pixel.x += step.x;}
+    err.y -= delta.y; if (err.y < 0) {err.y += steps; pixel.y += step.y;}
+    err.z -= delta.z; if (err.z < 0) {err.z += steps; pixel.z += step.z;}
+  }
+}
+
+void Leds::beginTransition(unsigned8 fx, unsigned16 duration) {
+  transition.indexes.clear();
+  if (mappingTable.size() == 0) { //no projection
+    for (forUnsigned16 indexP = 0; indexP < nrOfLeds && indexP < fixture->nrOfLeds; indexP++)
+      transition.indexes.push_back(indexP);
+  }
+  else {
+    std::vector<bool> added(fixture->nrOfLeds); //physical pixels can be mapped more than once
+    auto add = [this, &added](uint16_t indexP) {
+      if (indexP < added.size() && !added[indexP]) {
+        added[indexP] = true;
+        transition.indexes.push_back(indexP);
+      }
+    };
+    for (PhysMap &map: mappingTable) {
+      if (checkPalColorEffect()) { // checkPalColorEffect: temp method until all effects have been converted to Palette / 2 byte mapping mode
+        if (map.mapType == m_onePixel) add(map.indexP1);
+        else if (map.mapType == m_morePixels && map.indexes1 < mappingTableIndexes.size())
+          for (forUnsigned16 indexP: mappingTableIndexes[map.indexes1]) add(indexP);
+      }
+      else {
+        if (map.getMapType() == m_onePixel) add(map.indexP);
+        else if (map.getMapType() == m_morePixels)
+          for (forUnsigned16 indexP: *map.indexes) add(indexP);
+      }
+    }
+  }
+
+  transition.from.resize(transition.indexes.size());
+  transition.to.resize(transition.indexes.size());
+  storeFrame(transition.from);
+
+  transition.effectData.swap(effectData); //effectData of the previous transition (if any) is freed by the next allocate
+  transition.fx = fx;
+  transition.start = sys->now;
+  transition.duration = duration;
+  ppf("beginTransition fx:%d %d ms %d pixels\n", fx, duration, transition.indexes.size());
+}
+
+void Leds::endTransition() {
+  if (transition.fx == UINT8_MAX) return;
+  transition.fx = UINT8_MAX;
+  transition.effectData.freeBlocks();
+  transition.indexes.clear(); transition.indexes.shrink_to_fit();
+  transition.from.clear(); transition.from.shrink_to_fit();
+  transition.to.clear(); transition.to.shrink_to_fit();
+}
+
+void Leds::loadFrame(std::vector<CRGB> &frame) {
+  applyFade(); //not on the loaded frame
+  for (forUnsigned16 i = 0; i < transition.indexes.size(); i++)
+    fixture->ledsP[transition.indexes[i]] = frame[i];
+}
+
+void Leds::storeFrame(std::vector<CRGB> &frame) {
+  applyFade();
+  for (forUnsigned16 i = 0; i < transition.indexes.size(); i++)
+    frame[i] = fixture->ledsP[transition.indexes[i]];
+}
+
+void Leds::mixTransition(unsigned8 type, unsigned8 progress) {
+  unsigned16 nrOfPixels = transition.indexes.size();
+  for (forUnsigned16 i = 0; i < nrOfPixels; i++) {
+    CRGB &color = fixture->ledsP[transition.indexes[i]];
+    switch (type) {
+      case t_Wipe: //in physical order
+        color = (i * 255 < progress * nrOfPixels)?transition.to[i]:transition.from[i];
+        break;
+      case t_Dissolve: //each pixel switches at its own (fixed pseudo random) moment
+        color = (((i * 2654435761u) >> 24) < progress)?transition.to[i]:transition.from[i];
+        break;
+      default: //t_Fade
+        color = blend(transition.from[i], transition.to[i], progress);
+        break;
+    }
+  }
+}
+
 void PhysMap::addIndexP2(Leds &leds, uint16_t indexP) {
   // ppf("addIndexP2 i:%d t:%d", indexP, mapType);
   switch (mapType) {
@@ -121,12 +121,48 @@ class Fixture; //forward
 
 
 //StarLight implementation of segment.data
+//  the arena consists of blocks which are never moved (no realloc), so all pointers returned stay valid until the next allocate()
+//  allocate() creates the first block with the size an effect declares (Effect::dataSize), so normally one malloc per effect switch
+//  if an effect uses more than declared, an extra block is added (and logged) instead of moving the existing data
+//  if a block cannot be allocated, values are handed out from a zeroed dummy (nullptr if larger than the dummy) and failed() is true until the next allocate()
+//  define STARLIGHT_SHAREDDATA_GUARD to put guard bytes after each value and find overruns with checkGuards() (e.g. on the host)
+#define SHAREDDATA_GUARD_BYTES 4
+#define SHAREDDATA_GUARD_VALUE 0xA5
+#define SHAREDDATA_DUMMY_BYTES 256
+
 class SharedData {
 
   private:
-    byte *data;
-    unsigned16 index = 0;
-    unsigned16 bytesAllocated = 0;
+    struct Block {
+      byte *data;
+      unsigned16 size;
+      unsigned16 used; //high water mark, beyond this the block has not been handed out yet
+    };
+    std::vector<Block> blocks;
+    unsigned8 blockNr = 0; //block of the next value
+    unsigned16 index = 0; //next byte in blocks[blockNr]
+    bool allocationFailed = false;
+    #ifdef STARLIGHT_SHAREDDATA_GUARD
+      std::vector<byte *> guards; //start of each guard
+    #endif
+
+    //returns false if out of memory
+    bool addBlock(size_t size) {
+      size = (size + 7) & ~7; //multiple of 8: 8 byte aligned values fit at the end
+      byte *data = (byte*)calloc(size, 1);
+      if (data == nullptr) {
+        ppf("dev SharedData calloc %d failed\n", size);
+        return false;
+      }
+      blocks.push_back({data, (unsigned16)size, 0});
+      return true;
+    }
+
+    //handed out instead of a block value if out of memory, shared by all SharedData
+    static byte *dummy() {
+      static uint64_t dummyData[SHAREDDATA_DUMMY_BYTES / sizeof(uint64_t)]; //8 byte aligned
+      return (byte *)dummyData;
+    }
 
   public:
 
@@ -134,36 +170,117 @@ class SharedData {
     // ppf("SharedData constructor %d %d\n", index, bytesAllocated);
   }
   ~SharedData() {
-    // ppf("SharedData destructor WIP %d %d\n", index, bytesAllocated);
-    // free(data);
+    freeBlocks();
+  }
+
+  //owns its blocks: not copyable (a copy would free them twice), use swap() to move the data to another SharedData
+  SharedData(const SharedData &) = delete;
+  SharedData &operator=(const SharedData &) = delete;
+
+  //a block could not be allocated: values are not kept, do not run the effect
+  bool failed() {return allocationFailed;}
+
+  void freeBlocks() {
+    for (Block &block: blocks) free(block.data);
+    blocks.clear();
+    #ifdef STARLIGHT_SHAREDDATA_GUARD
+      guards.clear();
+    #endif
+    blockNr = 0;
+    index = 0;
+    allocationFailed = false;
   }
 
+  //frees the arena and allocates one zeroed block of size bytes, call once per effect switch
+  void allocate(size_t size) {
+    freeBlocks();
+    if (size) allocationFailed = !addBlock(size);
+    ppf("SharedData allocate %d%s\n", size, allocationFailed?" failed":"");
+  }
+
+  //all values 0, keeps the allocated blocks
   void reset() {
-    memset(data, 0, bytesAllocated);
+    for (Block &block: blocks) {
+      memset(block.data, 0, block.size);
+      block.used = 0;
+    }
+    #ifdef STARLIGHT_SHAREDDATA_GUARD
+      guards.clear();
+    #endif
+    blockNr = 0;
     index = 0;
   }
 
+  //FNV-1a of the values handed out so far (controls and effect variables), e.g. to see if anything changed
+  uint32_t hash() {
+    uint32_t result = 2166136261u;
+    for (Block &block: blocks)
+      for (forUnsigned16 i = 0; i < block.used; i++)
+        result = (result ^ block.data[i]) * 16777619u;
+    return result;
+  }
+
+  //exchanges the arenas, e.g. to keep the data of the previous effect during a transition
+  void swap(SharedData &other) {
+    std::swap(blocks, other.blocks);
+    std::swap(blockNr, other.blockNr);
+    std::swap(index, other.index);
+    std::swap(allocationFailed, other.allocationFailed);
+    #ifdef STARLIGHT_SHAREDDATA_GUARD
+      std::swap(guards, other.guards);
+    #endif
+  }
+
   //sets the effectData pointer back to 0 so loop effect can go through it
   void begin() {
+    blockNr = 0;
     index = 0;
   }
 
-  //returns the next pointer to a specified type (length for arrays)
+  //bytes allocated in all blocks
+  size_t bytesAllocated() {
+    size_t total = 0;
+    for (Block &block: blocks) total += block.size;
+    return total;
+  }
+
+  //returns the next pointer to a specified type (length for arrays), aligned for the type
   template <typename Type>
   Type * readWrite(int length = 1) {
-    size_t newIndex = index + length * sizeof(Type);
-    if (newIndex > bytesAllocated) {
-      size_t newSize = bytesAllocated + (1 + ( newIndex - bytesAllocated)/1024) * 1024; // add a multitude of 1024 bytes
-      ppf("bind add more %d->%d %d->%d\n", index, newIndex, bytesAllocated, newSize);
-      if (bytesAllocated == 0)
-        data = (byte*) malloc(newSize);
-      else
-        data = (byte*)realloc(data, newSize);
-      bytesAllocated = newSize;
+    size_t bytes = length * sizeof(Type);
+    #ifdef STARLIGHT_SHAREDDATA_GUARD
+      size_t needed = bytes + SHAREDDATA_GUARD_BYTES;
+    #else
+      size_t needed = bytes;
+    #endif
+    size_t start = (index + alignof(Type) - 1) & ~(alignof(Type) - 1);
+    //does not fit: try the next block (same order each loop so the same block is found)
+    while (blockNr < blocks.size() && start + needed > blocks[blockNr].size) {
+      blockNr++;
+      start = 0;
+    }
+    if (blockNr >= blocks.size()) {
+      //out of memory: never a pointer into a block which is too small
+      if (allocationFailed || !addBlock(max(needed, (size_t)1024))) {
+        allocationFailed = true;
+        if (bytes > SHAREDDATA_DUMMY_BYTES) return nullptr;
+        memset(dummy(), 0, bytes);
+        return reinterpret_cast<Type *>(dummy());
+      }
+      if (blocks.size() > 1) ppf("SharedData add block %d: %d bytes (more than declared)\n", blocks.size() - 1, blocks.back().size);
+      blockNr = blocks.size() - 1;
+      start = 0;
+    }
+    Block &block = blocks[blockNr];
+    Type * returnValue = reinterpret_cast<Type *>(block.data + start);
+    index = start + needed; //add consumed amount of bytes, index is next byte which will be pointed to
+    if (index > block.used) { //handed out for the first time
+      #ifdef STARLIGHT_SHAREDDATA_GUARD
+        memset(block.data + start + bytes, SHAREDDATA_GUARD_VALUE, SHAREDDATA_GUARD_BYTES);
+        guards.push_back(block.data + start + bytes);
+      #endif
+      block.used = index;
     }
-    // ppf("bind %d->%d %d\n", index, newIndex, bytesAllocated);
-    Type * returnValue  = reinterpret_cast<Type *>(data + index);
-    index = newIndex; //add consumed amount of bytes, index is next byte which will be pointed to
     return returnValue;
   }
 
@@ -182,6 +299,24 @@ class SharedData {
     return *result;
   }
 
+  #ifdef STARLIGHT_SHAREDDATA_GUARD
+    //returns false and logs if a value has been written beyond its size
+    bool checkGuards(const char *owner) {
+      bool ok = true;
+      for (byte *guard: guards) {
+        for (forUnsigned8 i = 0; i < SHAREDDATA_GUARD_BYTES; i++) {
+          if (guard[i] != SHAREDDATA_GUARD_VALUE) {
+            ppf("dev SharedData overrun %s at %p\n", owner, guard);
+            memset(guard, SHAREDDATA_GUARD_VALUE, SHAREDDATA_GUARD_BYTES); //report once
+            ok = false;
+            break;
+          }
+        }
+      }
+      return ok;
+    }
+  #endif
+
 };
 
 enum mapType {
@@ -281,6 +416,161 @@ struct PhysMap {
 
 }; // 4 bytes
 
+//polar coordinates of a pixel in the xy plane, see Leds::geoPolar
+struct GeoPolar {
+  uint8_t angle; //0..255 is a full circle
+  uint8_t radius; //distance to center * 180 / max(size.x, size.y)
+};
+
+//per layer cache of pixel geometry: a field is only built (and allocated) when an effect asks for it
+//  cleared by Leds::onRemap (size can have changed) and when the effect changes, normalized is rebuilt by onRemap
+struct GeometryCache {
+  std::vector<GeoPolar> polar; //x + y * size.x
+  float polarCenter[2] = {-1, -1}; //center polar has been built for
+
+  std::vector<uint8_t> normalized; //x, then y, then z, see Leds::geoNormalized
+
+  void clear() {
+    //shrink_to_fit to really give the memory back
+    polar.clear(); polar.shrink_to_fit();
+    normalized.clear(); normalized.shrink_to_fit();
+  }
+};
+
+//text rendered into columns, see Leds::rasterizeText
+struct TextStrip {
+  std::vector<uint16_t> columns; //bit y set: pixel y of the column is on (max 16 rows)
+  unsigned8 height = 0;
+
+  void clear() {
+    columns.clear(); columns.shrink_to_fit();
+    height = 0;
+  }
+};
+
+enum TransitionType {
+  t_Fade,
+  t_Wipe,
+  t_Dissolve,
+  t_count // keep as last entry
+};
+
+//effect transition: the previous effect keeps running on its own effectData and frame until the new effect has taken over
+//  frames are compact: only the physical pixels of the layer (indexes), see LedModEffects loop
+struct Transition {
+  unsigned8 fx = UINT8_MAX; //previous effect, UINT8_MAX if no transition running
+  SharedData effectData; //of the previous effect
+  unsigned long start = 0;
+  unsigned16 duration = 0; //ms
+  std::vector<uint16_t> indexes; //physical pixels of the layer
+  std::vector<CRGB> from; //frame of the previous effect
+  std::vector<CRGB> to; //frame of the new effect
+
+  //0..255, 255 if done
+  unsigned8 progress(unsigned long now) {
+    return (now - start >= duration)?255:(now - start) * 255 / duration;
+  }
+
+  //halve the remaining time, e.g. if frames take too long
+  void shorten(unsigned long now) {
+    if (now - start < duration) duration = (now - start) + (duration - (now - start)) / 2;
+  }
+};
+
+enum RenderModes {
+  r_All,
+  r_Interlace2, //every other row
+  r_Checker2, //every other pixel, alternating per row
+  r_Interlace4, //every fourth row
+  r_Checker4, //one pixel of each 2x2 block
+  r_count // keep as last entry
+};
+
+//the pixels an effect computes this frame if the layer renders a fraction of the pixels per frame (Leds::renderMode)
+//  effects opt in with: for (Coord3D pos: leds.pixelSubset()) {...}, the other pixels keep their previous value
+struct PixelSubset {
+  Coord3D size = {0,0,0};
+  unsigned8 xStep = 1;
+  unsigned8 yStep = 1;
+  unsigned8 yStart = 0;
+  unsigned8 xStart = 0;
+  bool checker = false; //xStart alternates per row
+
+  struct Iterator {
+    const PixelSubset *subset;
+    Coord3D pos;
+    Coord3D operator*() const {return pos;}
+    bool operator!=(const Iterator &other) const {return pos.x != other.pos.x || pos.y != other.pos.y || pos.z != other.pos.z;}
+    Iterator &operator++() {
+      pos.x += subset->xStep;
+      subset->nextRow(pos);
+      return *this;
+    }
+  };
+
+  int rowStart(int y) const {return checker?(y + xStart) & 1:xStart;}
+
+  //if pos.x is beyond the row, go to the next row of the subset (or end)
+  void nextRow(Coord3D &pos) const {
+    while (pos.z < size.z && pos.x >= size.x) {
+      pos.y += yStep;
+      if (pos.y >= size.y) {
+        pos.y = yStart;
+        pos.z++;
+      }
+      pos.x = rowStart(pos.y);
+    }
+    if (pos.z >= size.z) pos = {0, 0, size.z};
+  }
+
+  Iterator begin() const {
+    if (yStart >= size.y) return end();
+    Iterator it = {this, {rowStart(yStart), yStart, 0}};
+    nextRow(it.pos);
+    return it;
+  }
+  Iterator end() const {return {this, {0, 0, size.z}};}
+};
+
+//Random number stream per layer (xorshift32), same api as FastLED random8 / random16
+//  layers do not share (or reseed) the global FastLED generator, so a layer's output only depends on its own seed
+struct LedsRandom {
+  uint32_t state = 0x9E3779B9;
+
+  //0 is not a valid xorshift state
+  void seed(uint32_t value) {
+    state = value * 2654435761u; //spread small seeds over all bits
+    if (state == 0) state = 0x9E3779B9;
+  }
+
+  uint32_t next() {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+  }
+
+  uint8_t random8() {return next() >> 24;}
+  uint8_t random8(uint8_t lim) {return (random8() * lim) >> 8;}
+  uint8_t random8(uint8_t min, uint8_t lim) {return min + random8(lim - min);}
+  uint16_t random16() {return next() >> 16;}
+  uint16_t random16(uint16_t lim) {return ((uint32_t)random16() * lim) >> 16;}
+  uint16_t random16(uint16_t min, uint16_t lim) {return min + random16(lim - min);}
+
+  //batch: 4 random bytes per step
+  void fill(uint8_t *dest, size_t length) {
+    while (length >= 4) {
+      uint32_t value = next();
+      memcpy(dest, &value, 4);
+      dest += 4; length -= 4;
+    }
+    if (length) {
+      uint32_t value = next();
+      memcpy(dest, &value, length);
+    }
+  }
+};
+
 class Projection; //forward for cached virtual class methods!
 
 class Leds {
@@ -323,8 +613,28 @@ public:
 
   bool doMap = false;
 
+  unsigned8 fadePending[4]; //fadeBy values not applied yet, see fadeToBlackBy
+  unsigned8 nrOfFadesPending = 0;
+
   CRGBPalette16 palette;
 
+  unsigned8 renderScale = 1; //1, 2 or 4: effect renders at size / renderScale, see projectAndMap
+  unsigned8 renderMode = r_All; //see RenderModes, used by effects which iterate over pixelSubset()
+  unsigned8 renderPhase = 0; //which part of the pixels is rendered this frame
+
+  LedsRandom rng; //use leds.rng.random8() etc. in effects instead of the global random functions
+  uint32_t seed = 0; //0: seeded from time at each effect start, else deterministic: the same seed gives the same frames
+
+  unsigned16 firstIndexP = UINT16_MAX; //range of physical leds of the layer, set in projectAndMap
+  unsigned16 lastIndexP = 0;
+  unsigned32 renderMicros = 0; //last frame, to divide the layers over the cores
+
+  uint32_t staticHash = 0; //controlsHash() at the last rendered frame of a static effect, 0: render next frame
+
+  GeometryCache geometry;
+  TextStrip textStrip;
+  Transition transition;
+
   unsigned16 XY(unsigned16 x, unsigned16 y) {
     return XYZ(x, y, 0);
   }
@@ -350,6 +660,7 @@ public:
   ~Leds() {
     ppf("Leds destructor\n");
     fadeToBlackBy(100);
+    applyFade();
     doMap = true; // so loop is not running while deleting
     for (PhysMap &map:mappingTable) {
       if (checkPalColorEffect()) { // checkPalColorEffect: temp method until all effects have been converted to Palette / 2 byte mapping mode
@@ -364,8 +675,34 @@ public:
     mappingTable.clear();
   }
 
+  //what the output of a static effect depends on: its controls and the palette
+  uint32_t controlsHash() {
+    uint32_t result = effectData.hash();
+    for (forUnsigned8 i = 0; i < sizeof(palette.entries); i++)
+      result = (result ^ ((byte *)palette.entries)[i]) * 16777619u;
+    return result?result:1; //0 is reserved for render
+  }
+
+  //true if both layers can write the same physical leds (layers without leds do not overlap)
+  bool overlaps(Leds &other) {
+    return firstIndexP <= lastIndexP && other.firstIndexP <= other.lastIndexP && firstIndexP <= other.lastIndexP && other.firstIndexP <= lastIndexP;
+  }
+
+  //start the random stream of a new effect
+  void reseed() {rng.seed(seed?seed:micros());}
+
   void triggerMapping();
 
+  //called by projectAndMap after this layer has been (re)mapped
+  void onRemap();
+
+  //geometry of the virtual pixels, cached until the next remap. Center defaults to the middle of the layer
+  //  angle and radius around center in the xy plane, index x + y * size.x
+  GeoPolar *geoPolar(float cx = -1, float cy = -1);
+  //  coordinates normalized to a wave phase (cos8 / sin8): 8 per pixel, a full wave every 32 pixels
+  //  x at [x], y at [size.x + y], z at [size.x + size.y + z]. Built by onRemap
+  uint8_t *geoNormalized();
+
   // indexVLocal stored to be used by other operators
   Leds& operator[](unsigned16 indexV) {
     indexVLocal = indexV;
@@ -419,21 +756,34 @@ public:
   void addPixelColor(unsigned16 indexV, CRGB color) {setPixelColor(indexV, getPixelColor(indexV) + color);}
   void addPixelColor(Coord3D pixel, CRGB color) {setPixelColor(pixel, getPixelColor(pixel) + color);}
 
-  void drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, CRGB color) {
-    if (x0 >= size.x || x1 >= size.x || y0 >= size.y || y1 >= size.y) return;
-    const int16_t dx = abs(x1-x0), sx = x0<x1 ? 1 : -1;
-    const int16_t dy = abs(y1-y0), sy = y0<y1 ? 1 : -1;
-    int16_t err = (dx>dy ? dx : -dy)/2, e2;
-    for (;;) {
-      setPixelColor(XY(x0,y0), color);
-      if (x0==x1 && y0==y1) break;
-      e2 = err;
-      if (e2 >-dx) { err -= dy; x0 += sx; }
-      if (e2 < dy) { err += dx; y0 += sy; }
-    }
-  }
-
-  void fadeToBlackBy(unsigned8 fadeBy = 255);
+  //2D rasterizer: primitives are clipped to size up front and drawn as horizontal spans
+  //  a span resolves the row index once (if the projection does not adjust XYZ), then steps through the mapping
+  void drawSpan(int x0, int x1, int y, CRGB color, unsigned8 blendAmount = UINT8_MAX, int z = 0);
+  //soft: Wu anti-aliased
+  void drawLine(int x0, int y0, int x1, int y1, CRGB color, bool soft = false);
+  void drawThickLine(int x0, int y0, int x1, int y1, unsigned8 thickness, CRGB color);
+  void drawCircle(int cx, int cy, int radius, CRGB color, bool filled = false);
+  void fillRect(int x, int y, int width, int height, CRGB color);
+  //points of a convex polygon in drawing order (z ignored)
+  void fillPolygon(const Coord3D *points, unsigned8 nrOfPoints, CRGB color);
+
+  //3D primitives: each visits only the voxels inside its bounding box (clipped to size)
+  //  soft: anti-aliased by signed distance, voxels within half a pixel of the surface are blended by coverage
+  void drawSphere(float cx, float cy, float cz, float radius, CRGB color, bool soft = false);
+  void drawShell(float cx, float cy, float cz, float radius, float thickness, CRGB color, bool soft = false);
+  //plane: nx*x + ny*y + nz*z = offset (normal does not need to be normalized)
+  void drawPlane(float nx, float ny, float nz, float offset, float thickness, CRGB color, bool soft = false);
+  void drawBox(Coord3D from, Coord3D to, CRGB color);
+  void drawLine3D(Coord3D from, Coord3D to, CRGB color);
+
+  //fadeToBlackBy is deferred: fades are collected and applied in one pass by applyFade
+  //  which runs before the layer is drawn on or read, before a remap, and after the effect loop (LedModEffects)
+  //  so n fades in a row cost one walk over the mapping table, black pixels are skipped, and a fill which overwrites all pixels skips the fade
+  void fadeToBlackBy(unsigned8 fadeBy = 255) {
+    if (nrOfFadesPending == sizeof(fadePending)) applyFade();
+    fadePending[nrOfFadesPending++] = fadeBy;
+  }
+  void applyFade();
   void fill_solid(const struct CRGB& color, bool noBlend = false);
   void fill_rainbow(unsigned8 initialhue, unsigned8 deltahue);
 
@@ -517,16 +867,8 @@ public:
   //shift is used by drawText indicating which letter it is drawing
   void drawCharacter(unsigned char chr, int x = 0, int16_t y = 0, unsigned8 font = 0, CRGB col = CRGB::Red, unsigned16 shiftPixel = 0, unsigned16 shiftChr = 0) {
     if (chr < 32 || chr > 126) return; // only ASCII 32-126 supported
-    chr -= 32; // align with font table entries
 
-    Coord3D fontSize;
-    switch (font%5) {
-      case 0: fontSize.x = 4; fontSize.y = 6; break;
-      case 1: fontSize.x = 5; fontSize.y = 8; break;
-      case 2: fontSize.x = 5; fontSize.y = 12; break;
-      case 3: fontSize.x = 6; fontSize.y = 8; break;
-      case 4: fontSize.x = 7; fontSize.y = 9; break;
-    }
+    Coord3D fontSize = fontSizeOf(font);
 
     Coord3D chrPixel;
     for (chrPixel.y = 0; chrPixel.y<fontSize.y; chrPixel.y++) { // character height
@@ -534,14 +876,7 @@ public:
       pixel.z = 0;
       pixel.y = y + chrPixel.y;
       if (pixel.y >= 0 && pixel.y < size.y) {
-        byte bits = 0;
-        switch (font%5) {
-          case 0: bits = pgm_read_byte_near(&console_font_4x6[(chr * fontSize.y) + chrPixel.y]); break;
-          case 1: bits = pgm_read_byte_near(&console_font_5x8[(chr * fontSize.y) + chrPixel.y]); break;
-          case 2: bits = pgm_read_byte_near(&console_font_5x12[(chr * fontSize.y) + chrPixel.y]); break;
-          case 3: bits = pgm_read_byte_near(&console_font_6x8[(chr * fontSize.y) + chrPixel.y]); break;
-          case 4: bits = pgm_read_byte_near(&console_font_7x9[(chr * fontSize.y) + chrPixel.y]); break;
-        }
+        byte bits = fontRow(font, chr, chrPixel.y);
 
         for (chrPixel.x = 0; chrPixel.x<fontSize.x; chrPixel.x++) {
           //x adjusted by: chr in text, scroll value, font column
@@ -561,6 +896,84 @@ public:
     }
   }
 
+  //renders text once into textStrip, to be drawn each frame by drawTextStrip (no font lookups per frame)
+  //  proportional: each character gets the columns it uses + 1 spacing column, a space gets half the font width
+  void rasterizeText(const char * text, unsigned8 font = 0, bool proportional = true);
+
+  //columns drawTextStrip wraps around at: the text, or the layer width if the text is shorter
+  unsigned16 textStripWidth();
+  //draws the visible window of textStrip, starting at column offset (take it modulo textStripWidth, so a scrolling counter does not jump when it wraps)
+  void drawTextStrip(unsigned16 offset = 0, int16_t y = 0, CRGB col = CRGB::Red);
+
+  static Coord3D fontSizeOf(unsigned8 font) {
+    switch (font%5) {
+      case 0: return {4, 6, 0};
+      case 1: return {5, 8, 0};
+      case 2: return {5, 12, 0};
+      case 3: return {6, 8, 0};
+      default: return {7, 9, 0};
+    }
+  }
+
+  //bits of one row of a character, most left column in bit 7
+  static byte fontRow(unsigned8 font, unsigned char chr, unsigned8 row) {
+    chr -= 32; // align with font table entries
+    switch (font%5) {
+      case 0: return pgm_read_byte_near(&console_font_4x6[(chr * 6) + row]);
+      case 1: return pgm_read_byte_near(&console_font_5x8[(chr * 8) + row]);
+      case 2: return pgm_read_byte_near(&console_font_5x12[(chr * 12) + row]);
+      case 3: return pgm_read_byte_near(&console_font_6x8[(chr * 8) + row]);
+      default: return pgm_read_byte_near(&console_font_7x9[(chr * 9) + row]);
+    }
+  }
+
+  //1, 2 or 4: each pixel is rendered once per renderFraction frames
+  unsigned8 renderFraction(unsigned8 renderMode) {
+    return (renderMode == r_Interlace4 || renderMode == r_Checker4)?4:(renderMode == r_All)?1:2;
+  }
+  unsigned8 renderFraction() {return renderFraction(renderMode);}
+
+  //call once per frame, before the effect runs
+  void nextRenderPhase() {
+    renderPhase = (renderPhase + 1) % renderFraction();
+  }
+
+  PixelSubset pixelSubset() {
+    PixelSubset subset;
+    subset.size = size;
+    switch (renderMode) {
+      case r_Interlace2:
+      case r_Interlace4:
+        subset.yStep = renderFraction();
+        subset.yStart = renderPhase;
+        break;
+      case r_Checker2:
+        subset.xStep = 2;
+        subset.xStart = renderPhase;
+        subset.checker = true;
+        break;
+      case r_Checker4:
+        subset.xStep = 2;
+        subset.yStep = 2;
+        subset.xStart = renderPhase & 1;
+        subset.yStart = renderPhase >> 1;
+        break;
+    }
+    return subset;
+  }
+
+  //no projection or only one layer: buffer operations can work on ledsP directly
+  bool isFastPath();
+
+  //keeps effectData and the current frame for the previous effect fx, the new effect gets a fresh effectData
+  void beginTransition(unsigned8 fx, unsigned16 duration);
+  void endTransition();
+  //copy a compact transition frame to / from ledsP
+  void loadFrame(std::vector<CRGB> &frame);
+  void storeFrame(std::vector<CRGB> &frame);
+  //writes the mix of the from and to frames into ledsP
+  void mixTransition(unsigned8 type, unsigned8 progress);
+
   // checkPalColorEffect: temp method until all effects have been converted to Palette / 2 byte mapping mode
   //     add id's of all converted methods here
   bool checkPalColorEffect() {
@@ -570,4 +983,10 @@ public:
            ;
   }
 
+private:
+  void fadePixel(unsigned16 indexP, unsigned8 nrOfFades); //applies fadePending[0..nrOfFades-1] to ledsP[indexP]
+  #ifdef STARLIGHT_FADE_CHECK
+    void fadePass(CRGB *buffer, unsigned8 fadeBy);
+  #endif
+
 };
\ No newline at end of file
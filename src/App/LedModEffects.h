@@ -14,6 +14,11 @@
 #include "LedFixture.h"
 #include "LedEffects.h"
 #include "LedProjections.h"
+#include "LedModulators.h"
+#include "LedPacer.h"
+#include "LedGovernor.h"
+
+#include <atomic>
 
 #ifdef STARLIGHT_CLOCKLESS_LED_DRIVER
   #if CONFIG_IDF_TARGET_ESP32S3 || CONFIG_IDF_TARGET_ESP32S2
@@ -42,14 +47,37 @@ public:
   bool newFrame = false; //for other modules (DDP)
 
   unsigned16 fps = 60;
+  bool pacerSleep = false; //sleep until the next frame instead of running the loop of all modules meanwhile
+  FramePacer pacer;
+  unsigned16 outputFps = 0; //if higher than fps: frames in between are blended from the last two rendered frames
+  FramePacer outputPacer;
   unsigned long lastMappingMillis = 0;
 
-  std::vector<Effect *> effects;
+  Registry<Effect> effects;
 
   Fixture fixture = Fixture();
 
   bool fShow = true;
 
+  unsigned16 transitionMs = 0; //0: no transition, the new effect starts right away
+  unsigned8 transitionType = t_Fade;
+  unsigned8 transitionMinFps = 20;
+
+  bool record = false; //toggled by the record button, not saved so a reboot does not overwrite the recording
+  unsigned16 recordMaxKB = 1024;
+
+  bool pipeline = false; //show on the other core while the next frame is rendered (FastLED)
+  bool parallel = false; //render layers on both cores
+
+  bool skipStatic = true;
+  unsigned16 keepAliveMs = 1000; //0: static frames are not shown again
+  bool frameChanged = false; //set if the output changes outside the effects (e.g. brightness), so the next frame is shown
+
+  bool govern = false; //step quality knobs down if the frame time exceeds 1000000 / fps
+  FrameGovernor governor;
+
+  Modulators modulators;
+
   #ifdef STARLIGHT_CLOCKLESS_LED_DRIVER
     #if CONFIG_IDF_TARGET_ESP32S3 || CONFIG_IDF_TARGET_ESP32S2
       I2SClocklessLedDriveresp32S3 driver;
@@ -60,78 +88,84 @@ public:
 
   LedModEffects() :SysModule("Effects") {
 
-    //load effects
-
-    //1D Basis
-    effects.push_back(new SolidEffect);
-    // 1D FastLed
-    effects.push_back(new RainbowEffect);
-    effects.push_back(new RainbowWithGlitterEffect);
-    effects.push_back(new FlowEffect);
-    effects.push_back(new SinelonEffect);
-    effects.push_back(new ConfettiEffect);
-    effects.push_back(new BPMEffect);
-    effects.push_back(new JuggleEffect);
-    //1D StarLight
-    effects.push_back(new RunningEffect);
-    effects.push_back(new RingRandomFlow);
-    // 1D WLED
-    effects.push_back(new BouncingBalls);
-    effects.push_back(new RainEffect);
-    effects.push_back(new DripEffect);
-    effects.push_back(new HeartBeatEffect);
-
-    #ifdef STARLIGHT_USERMOD_WLEDAUDIO
-      //1D Volume
-      effects.push_back(new FreqMatrix);
-      effects.push_back(new PopCorn);
-      effects.push_back(new NoiseMeter);
-      //1D frequency
-      effects.push_back(new AudioRings);
-      effects.push_back(new DJLight);
-    #endif
+    //effects and projections are created when selected, the tables are const (flash)
+    static const RegistryEntry<Effect> effectEntries[] = {
+
+      //1D Basis
+      REGISTER_EFFECT(SolidEffect),
+      // 1D FastLed
+      REGISTER_EFFECT(RainbowEffect),
+      REGISTER_EFFECT(RainbowWithGlitterEffect),
+      REGISTER_EFFECT(FlowEffect),
+      REGISTER_EFFECT(SinelonEffect),
+      REGISTER_EFFECT(ConfettiEffect),
+      REGISTER_EFFECT(BPMEffect),
+      REGISTER_EFFECT(JuggleEffect),
+      //1D StarLight
+      REGISTER_EFFECT(RunningEffect),
+      REGISTER_EFFECT(RingRandomFlow),
+      // 1D WLED
+      REGISTER_EFFECT(BouncingBalls),
+      REGISTER_EFFECT(RainEffect),
+      REGISTER_EFFECT(DripEffect),
+      REGISTER_EFFECT(HeartBeatEffect),
 
-    //2D StarLight
-    effects.push_back(new LinesEffect);
-    //2D WLED
-    effects.push_back(new BlackHole);
-    effects.push_back(new DNA);
-    effects.push_back(new DistortionWaves);
-    effects.push_back(new Octopus);
-    effects.push_back(new Lissajous);
-    effects.push_back(new Frizzles);
-    effects.push_back(new ScrollingText);
-    effects.push_back(new Noise2D);
-    effects.push_back(new GameOfLife);
-    effects.push_back(new RubiksCube);
-    effects.push_back(new ParticleTest);
-    #ifdef STARLIGHT_USERMOD_WLEDAUDIO
+      #ifdef STARLIGHT_USERMOD_WLEDAUDIO
+        //1D Volume
+        REGISTER_EFFECT(FreqMatrix),
+        REGISTER_EFFECT(PopCorn),
+        REGISTER_EFFECT(NoiseMeter),
+        //1D frequency
+        REGISTER_EFFECT(AudioRings),
+        REGISTER_EFFECT(DJLight),
+      #endif
+
+      //2D StarLight
+      REGISTER_EFFECT(LinesEffect),
       //2D WLED
-      effects.push_back(new Waverly);
-      effects.push_back(new GEQEffect);
-      effects.push_back(new LaserGEQEffect);
-      effects.push_back(new FunkyPlank);
-    #endif
-    //3D
-    effects.push_back(new RipplesEffect);
-    effects.push_back(new SphereMoveEffect);
-    effects.push_back(new PixelMapEffect);
-
-    //load projections
-    fixture.projections.push_back(new NoneProjection);
-    fixture.projections.push_back(new DefaultProjection);
-    fixture.projections.push_back(new PinwheelProjection);
-    fixture.projections.push_back(new MultiplyProjection);
-    fixture.projections.push_back(new TiltPanRollProjection);
-    fixture.projections.push_back(new DistanceFromPointProjection);
-    fixture.projections.push_back(new Preset1Projection);
-    fixture.projections.push_back(new RandomProjection);
-    fixture.projections.push_back(new ReverseProjection);
-    fixture.projections.push_back(new MirrorProjection);
-    fixture.projections.push_back(new GroupingProjection);
-    fixture.projections.push_back(new SpacingProjection);
-    fixture.projections.push_back(new TransposeProjection);
-    fixture.projections.push_back(new KaleidoscopeProjection);
+      REGISTER_EFFECT(BlackHole),
+      REGISTER_EFFECT(DNA),
+      REGISTER_EFFECT(DistortionWaves),
+      REGISTER_EFFECT(Octopus),
+      REGISTER_EFFECT(Lissajous),
+      REGISTER_EFFECT(Frizzles),
+      REGISTER_EFFECT(ScrollingText),
+      REGISTER_EFFECT(Noise2D),
+      REGISTER_EFFECT(GameOfLife),
+      REGISTER_EFFECT(RubiksCube),
+      REGISTER_EFFECT(ParticleTest),
+      #ifdef STARLIGHT_USERMOD_WLEDAUDIO
+        //2D WLED
+        REGISTER_EFFECT(Waverly),
+        REGISTER_EFFECT(GEQEffect),
+        REGISTER_EFFECT(LaserGEQEffect),
+        REGISTER_EFFECT(FunkyPlank),
+      #endif
+      //3D
+      REGISTER_EFFECT(RipplesEffect),
+      REGISTER_EFFECT(SphereMoveEffect),
+      REGISTER_EFFECT(PixelMapEffect),
+      REGISTER_EFFECT(PlaybackEffect),
+    };
+    effects.begin(effectEntries, sizeof(effectEntries) / sizeof(effectEntries[0]));
+
+    static const RegistryEntry<Projection> projectionEntries[] = {
+      REGISTER_PROJECTION(NoneProjection),
+      REGISTER_PROJECTION(DefaultProjection),
+      REGISTER_PROJECTION(PinwheelProjection),
+      REGISTER_PROJECTION(MultiplyProjection),
+      REGISTER_PROJECTION(TiltPanRollProjection),
+      REGISTER_PROJECTION(DistanceFromPointProjection),
+      REGISTER_PROJECTION(Preset1Projection),
+      REGISTER_PROJECTION(RandomProjection),
+      REGISTER_PROJECTION(ReverseProjection),
+      REGISTER_PROJECTION(MirrorProjection),
+      REGISTER_PROJECTION(GroupingProjection),
+      REGISTER_PROJECTION(SpacingProjection),
+      REGISTER_PROJECTION(TransposeProjection),
+      REGISTER_PROJECTION(KaleidoscopeProjection),
+    };
+    fixture.projections.begin(projectionEntries, sizeof(projectionEntries) / sizeof(projectionEntries[0]));
 
     #ifdef STARLIGHT_CLOCKLESS_LED_DRIVER
       #if !(CONFIG_IDF_TARGET_ESP32S3 || CONFIG_IDF_TARGET_ESP32S2)
@@ -143,6 +177,8 @@ public:
   void setup() {
     SysModule::setup();
 
+    ppf("Effects registry %d effects, %d projections (objects created when selected)\n", effects.size(), fixture.projections.size());
+
     parentVar = ui->initAppMod(parentVar, name, 1201);
 
     JsonObject currentVar;
@@ -166,8 +202,10 @@ public:
         //tbd: fade to black
         if (rowNr <fixture.listOfLeds.size()) {
           Leds *leds = fixture.listOfLeds[rowNr];
+          if (leds->fx < effects.size()) effects[leds->fx]->teardown(*leds);
           fixture.listOfLeds.erase(fixture.listOfLeds.begin() + rowNr); //remove from vector
           delete leds; //remove leds itself
+          frameChanged = true; //show the removed pixels
         }
         return true; }
       default: return false;
@@ -182,12 +220,13 @@ public:
         ui->setLabel(var, "Effect");
         ui->setComment(var, "Effect to show");
         JsonArray options = ui->setOptions(var);
-        for (Effect *effect:effects) {
+        for (forUnsigned8 index = 0; index < effects.size(); index++) { //from the registry, no effects created
+          const RegistryEntry<Effect> &effect = effects.entry(index);
           char buf[32] = "";
-          strcat(buf, effect->name());
-          strcat(buf, effect->dim()==_1D?" ┊":effect->dim()==_2D?" ▦":" 🧊");
+          strcat(buf, effect.name);
+          strcat(buf, effect.dim==_1D?" ┊":effect.dim==_2D?" ▦":" 🧊");
           strcat(buf, " ");
-          strcat(buf, effect->tags());
+          strcat(buf, effect.tags);
           options.add(JsonString(buf, JsonString::Copied)); //copy!
         }
         return true; }
@@ -208,6 +247,7 @@ public:
 
           bool oldPal = leds->checkPalColorEffect(); // checkPalColorEffect: temp method until all effects have been converted to Palette / 2 byte mapping mode
 
+          stackUnsigned8 oldFx = leds->fx;
           leds->fx = mdl->getValue(var, rowNr);
 
           ppf("setEffect fx[%d]: %d\n", rowNr, leds->fx);
@@ -216,21 +256,41 @@ public:
 
             Effect* effect = effects[leds->fx];
 
+            modulators.unbind(); //controls get new slots in effectData
+
+            if (oldFx < effects.size()) effects[oldFx]->teardown(*leds); //also if the same effect is selected again: its effectData is allocated again
+
+            //keep the previous effect running until the new effect has faded in
+            if (transitionMs && oldFx < effects.size() && oldFx != leds->fx)
+              leds->beginTransition(oldFx, transitionMs);
+            else
+              leds->endTransition();
+
             // effect->loop(leds); //do a loop to set effectData right
-            leds->effectData.reset(); //make sure all values are 0 and reset for a fresh start of the effect
+            leds->effectData.allocate(effect->dataSize(*leds)); //one zeroed block for all values for a fresh start of the effect
+            leds->geometry.clear(); //new effect builds the fields it needs
+            leds->textStrip.clear();
+            leds->reseed(); //same seed: same frames
+            leds->staticHash = 0; //render at least once
             // leds->effectData.begin();
             mdl->varPreDetails(var, rowNr);
             effect->controls(*leds, var);
             mdl->varPostDetails(var, rowNr);
 
-            effect->setup(*leds); //if changed then run setup once (like call==0 in WLED)
+            if (!leds->effectData.failed()) effect->setup(*leds); //if changed then run setup once (like call==0 in WLED)
+
+            if (leds->transition.fx != UINT8_MAX) { //setup (e.g. fill_solid) is the first frame of the new effect, show the previous effect
+              leds->storeFrame(leds->transition.to);
+              leds->loadFrame(leds->transition.from);
+            }
 
             ppf("control ");
             print->printVar(var);
             ppf("\n");
 
-            if (effect->dim() != leds->effectDimension || oldPal != leds->checkPalColorEffect()) { // checkPalColorEffect: temp method until all effects have been converted to Palette / 2 byte mapping mode
-              leds->effectDimension = effect->dim();
+            if (effects.entry(leds->fx).dim != leds->effectDimension || oldPal != leds->checkPalColorEffect()) { // checkPalColorEffect: temp method until all effects have been converted to Palette / 2 byte mapping mode
+              leds->effectDimension = effects.entry(leds->fx).dim;
+              leds->endTransition(); //pixels of the layer change
               leds->triggerMapping();
             }
             else
@@ -254,12 +314,13 @@ public:
         ui->setComment(var, "How to project fx");
 
         JsonArray options = ui->setOptions(var);
-        for (Projection *projection:fixture.projections) {
+        for (forUnsigned8 index = 0; index < fixture.projections.size(); index++) { //from the registry, no projections created
+          const RegistryEntry<Projection> &projection = fixture.projections.entry(index);
           char buf[32] = "";
-          strcat(buf, projection->name());
+          strcat(buf, projection.name);
           // strcat(buf, projection->dim()==_1D?" ┊":projection->dim()==_2D?" ▦":" 🧊");
           strcat(buf, " ");
-          strcat(buf, projection->tags());
+          strcat(buf, projection.tags);
           options.add(JsonString(buf, JsonString::Copied)); //copy!
         }
         return true; }
@@ -377,6 +438,66 @@ public:
       default: return false;
     }});
 
+    ui->initSelect(tableVar, "scale", 0, false, [this](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onSetValue:
+        for (forUnsigned8 rowNr = 0; rowNr < fixture.listOfLeds.size(); rowNr++)
+          mdl->setValue(var, fixture.listOfLeds[rowNr]->renderScale >> 1, rowNr); //1, 2, 4 -> 0, 1, 2
+        return true;
+      case onUI: {
+        ui->setLabel(var, "Scale");
+        ui->setComment(var, "Effect resolution");
+        JsonArray options = ui->setOptions(var);
+        options.add("1:1");
+        options.add("1:2");
+        options.add("1:4");
+        return true; }
+      case onChange:
+        if (rowNr < fixture.listOfLeds.size())
+          governLayer(rowNr);
+        return true;
+      default: return false;
+    }});
+
+    ui->initSelect(tableVar, "render", r_All, false, [this](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onSetValue:
+        for (forUnsigned8 rowNr = 0; rowNr < fixture.listOfLeds.size(); rowNr++)
+          mdl->setValue(var, fixture.listOfLeds[rowNr]->renderMode, rowNr);
+        return true;
+      case onUI: {
+        ui->setLabel(var, "Render");
+        ui->setComment(var, "Pixels computed per frame (effects supporting it)");
+        JsonArray options = ui->setOptions(var);
+        options.add("All"); //r_All
+        options.add("Interlace ½"); //r_Interlace2
+        options.add("Checker ½"); //r_Checker2
+        options.add("Interlace ¼"); //r_Interlace4
+        options.add("Checker ¼"); //r_Checker4
+        return true; }
+      case onChange:
+        if (rowNr < fixture.listOfLeds.size())
+          governLayer(rowNr);
+        return true;
+      default: return false;
+    }});
+
+    ui->initNumber(tableVar, "seed", 0, 0, UINT16_MAX, false, [this](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onSetValue:
+        for (forUnsigned8 rowNr = 0; rowNr < fixture.listOfLeds.size(); rowNr++)
+          mdl->setValue(var, fixture.listOfLeds[rowNr]->seed, rowNr);
+        return true;
+      case onUI:
+        ui->setLabel(var, "Seed");
+        ui->setComment(var, "0: random, else same frames each run");
+        return true;
+      case onChange:
+        if (rowNr < fixture.listOfLeds.size()) {
+          fixture.listOfLeds[rowNr]->seed = mdl->getValue(var, rowNr);
+          fixture.listOfLeds[rowNr]->reseed();
+        }
+        return true;
+      default: return false;
+    }});
+
     ui->initText(tableVar, "ledsSize", nullptr, 32, true, [this](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
       case onSetValue: {
         // for (std::vector<Leds *>::iterator leds=fixture.listOfLeds.begin(); leds!=fixture.listOfLeds.end(); ++leds) {
@@ -411,6 +532,265 @@ public:
 
     ui->initSlider(parentVar, "Blending", &fixture.globalBlend);
 
+    tableVar = ui->initTable(parentVar, "modTbl", nullptr, false, [this](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Modulators");
+        ui->setComment(var, "Change effect controls over time");
+        return true;
+      case onAddRow:
+        rowNr = modulators.list.size();
+        web->getResponseObject()["addRow"]["rowNr"] = rowNr;
+        modulators.row(rowNr);
+        return true;
+      case onDeleteRow:
+        if (rowNr < modulators.list.size()) {
+          modulators.list.erase(modulators.list.begin() + rowNr);
+          modulators.unbind();
+        }
+        return true;
+      default: return false;
+    }});
+
+    ui->initText(tableVar, "modVar", nullptr, 31, false, [this](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Control");
+        ui->setComment(var, "e.g. speed");
+        return true;
+      case onChange: {
+        Modulator *mod = modulators.row(rowNr);
+        const char *varId = mdl->getValue(var, rowNr);
+        if (mod) strncpy(mod->varId, varId?varId:"", sizeof(mod->varId) - 1);
+        return true; }
+      default: return false;
+    }});
+
+    ui->initNumber(tableVar, "modLayer", 0, 0, 255, false, [this](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Layer");
+        ui->setComment(var, "Row in Effects");
+        return true;
+      case onChange: {
+        Modulator *mod = modulators.row(rowNr);
+        if (mod) mod->rowNr = mdl->getValue(var, rowNr);
+        return true; }
+      default: return false;
+    }});
+
+    ui->initSelect(tableVar, "modSource", mod_Sine, false, [this](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI: {
+        ui->setLabel(var, "Source");
+        JsonArray options = ui->setOptions(var);
+        options.add("Sine"); //mod_Sine
+        options.add("Saw"); //mod_Saw
+        options.add("Random walk"); //mod_RandomWalk
+        options.add("Audio band"); //mod_Audio
+        options.add("Gyro"); //mod_Gyro
+        return true; }
+      case onChange: {
+        Modulator *mod = modulators.row(rowNr);
+        if (mod) mod->source = mdl->getValue(var, rowNr);
+        return true; }
+      default: return false;
+    }});
+
+    ui->initSlider(tableVar, "modRate", 60, 0, 255, false, [this](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Rate");
+        ui->setComment(var, "bpm, step, band or axis");
+        return true;
+      case onChange: {
+        Modulator *mod = modulators.row(rowNr);
+        if (mod) mod->rate = mdl->getValue(var, rowNr);
+        return true; }
+      default: return false;
+    }});
+
+    ui->initNumber(tableVar, "modMin", 0, 0, UINT16_MAX, false, [this](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Min");
+        return true;
+      case onChange: {
+        Modulator *mod = modulators.row(rowNr);
+        if (mod) mod->min = mdl->getValue(var, rowNr);
+        return true; }
+      default: return false;
+    }});
+
+    ui->initNumber(tableVar, "modMax", 255, 0, UINT16_MAX, false, [this](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Max");
+        return true;
+      case onChange: {
+        Modulator *mod = modulators.row(rowNr);
+        if (mod) mod->max = mdl->getValue(var, rowNr);
+        return true; }
+      default: return false;
+    }});
+
+    ui->initButton(parentVar, "record", false, [this](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Record");
+        ui->setComment(var, "Start / stop frames to /name.slr, play with the Playback effect");
+        return true;
+      case onChange:
+        record = !record; //started / stopped in the loop
+        return true;
+      default: return false;
+    }});
+
+    ui->initText(parentVar, "recordName", "show", 24, false, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Name");
+        return true;
+      default: return false;
+    }});
+
+    ui->initNumber(parentVar, "recordMax", &recordMaxKB, 1, 16384, false, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Max size");
+        ui->setComment(var, "KB, recording stops at this size");
+        return true;
+      default: return false;
+    }});
+
+    ui->initText(parentVar, "recordState", nullptr, 48, true, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Recording");
+        return true;
+      default: return false;
+    }});
+
+    ui->initText(parentVar, "playbackFps", nullptr, 16, true, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Playback max");
+        ui->setComment(var, "fps reading from file");
+        return true;
+      default: return false;
+    }});
+
+    #ifndef STARLIGHT_CLOCKLESS_LED_DRIVER
+      ui->initCheckBox(parentVar, "pipeline", &pipeline, false, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+        case onUI:
+          ui->setLabel(var, "Pipeline");
+          ui->setComment(var, "Show on the other core while rendering the next frame");
+          return true;
+        default: return false;
+      }});
+    #endif
+
+    #if !CONFIG_FREERTOS_UNICORE
+      ui->initCheckBox(parentVar, "parallel", &parallel, false, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+        case onUI:
+          ui->setLabel(var, "Parallel");
+          ui->setComment(var, "Render layers without shared leds on both cores");
+          return true;
+        default: return false;
+      }});
+    #endif
+
+    ui->initText(parentVar, "frameStages", nullptr, 48, true, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Frame stages");
+        ui->setComment(var, "render, show, wait for show");
+        return true;
+      default: return false;
+    }});
+
+    currentVar = ui->initCheckBox(parentVar, "govern", &govern, false, [this](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Governor");
+        ui->setComment(var, "Lower quality to hold fps, in the order below");
+        return true;
+      case onChange:
+        if (!govern && governor.reset()) governAll();
+        return true;
+      default: return false;
+    }});
+
+    const char *govLabels[gov_count] = {"Preview rate", "Interlace", "Scale", "Network rate"};
+    const char *govIds[gov_count] = {"govPreview", "govInterlace", "govScale", "govNetwork"};
+    for (forUnsigned8 knob = 0; knob < gov_count; knob++) {
+      const char *label = govLabels[knob];
+      ui->initCheckBox(currentVar, govIds[knob], &governor.permitted[knob], false, [this, knob, label](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+        case onUI:
+          ui->setLabel(var, label);
+          return true;
+        case onChange:
+          if (!governor.permitted[knob] && governor.level[knob]) { //not permitted anymore: back to full quality
+            governor.level[knob] = 0;
+            governAll();
+          }
+          return true;
+        default: return false;
+      }});
+    }
+
+    ui->initText(currentVar, "govState", nullptr, 64, true, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "State");
+        ui->setComment(var, "knob levels and last change");
+        return true;
+      default: return false;
+    }});
+
+    ui->initCheckBox(parentVar, "skipStatic", &skipStatic, false, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Skip static");
+        ui->setComment(var, "No render and show if nothing changes");
+        return true;
+      default: return false;
+    }});
+
+    ui->initNumber(parentVar, "keepAlive", &keepAliveMs, 0, 60000, false, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Keep alive");
+        ui->setComment(var, "ms, show static frames again, 0: never");
+        return true;
+      default: return false;
+    }});
+
+    ui->initText(parentVar, "framesSkipped", nullptr, 16, true, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Frames skipped");
+        return true;
+      default: return false;
+    }});
+
+    ui->initText(parentVar, "effectsIdle", nullptr, 16, true, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Idle");
+        ui->setComment(var, "time not rendering or showing");
+        return true;
+      default: return false;
+    }});
+
+    ui->initNumber(parentVar, "transition", &transitionMs, 0, 10000, false, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Transition");
+        ui->setComment(var, "ms, 0: no transition");
+        return true;
+      default: return false;
+    }});
+
+    ui->initSelect(parentVar, "transitionType", &transitionType, false, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI: {
+        ui->setLabel(var, "Transition type");
+        JsonArray options = ui->setOptions(var);
+        options.add("Fade"); //t_Fade
+        options.add("Wipe"); //t_Wipe
+        options.add("Dissolve"); //t_Dissolve
+        return true; }
+      default: return false;
+    }});
+
+    ui->initSlider(parentVar, "transitionMinFps", &transitionMinFps, 1, 255, false, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Min fps");
+        ui->setComment(var, "Transitions are shortened below");
+        return true;
+      default: return false;
+    }});
+
     #ifdef STARBASE_USERMOD_E131
       // if (e131mod->isEnabled) {
           e131mod->patchChannel(0, "bri", 255); //should be 256??
@@ -440,56 +820,116 @@ public:
   void loop() {
     // SysModule::loop();
 
-    random16_set_seed(sys->now);
-
     //set new frame
-    if (sys->now - frameMillis >= 1000.0/fps) {
-      frameMillis = sys->now;
+    if (pacer.due(fps)) {
 
       newFrame = true;
 
       //for each programmed effect
       //  run the next frame of the effect
-      stackUnsigned8 rowNr = 0;
-      for (Leds *leds: fixture.listOfLeds) {
-        if (!leds->doMap) { // don't run effect while remapping
-          // ppf(" %d %d,%d,%d - %d,%d,%d (%d,%d,%d)", leds->fx, leds->startPos.x, leds->startPos.y, leds->startPos.z, leds->endPos.x, leds->endPos.y, leds->endPos.z, leds->size.x, leds->size.y, leds->size.z );
-          mdl->getValueRowNr = rowNr++;
-
-          leds->effectData.begin(); //sets the effectData pointer back to 0 so loop effect can go through it
-          effects[leds->fx]->loop(*leds);
-
-          mdl->getValueRowNr = UINT8_MAX;
-          // if (leds->projectionNr == p_TiltPanRoll || leds->projectionNr == p_Preset1)
-          //   leds->fadeToBlackBy(50);
-        }
+      modulators.loop(); //before the effects read their controls
+
+      //nothing changed: no render and no show (the network senders also skip the frame)
+      if (isStaticFrame()) {
+        framesSkipped++;
+        newFrame = false;
       }
+      else {
+        unsigned long frameMicros = micros();
+        bool inTransition = false;
+
+        //start / stop here and not in onChange, so the keyframes are not freed while blending
+        //  begin each frame: keyframes follow a remap to another number of leds
+        if (outputFps > fps) {
+          if (!fixture.interpolator.begin(fixture.nrOfLeds))
+            fixture.interpolator.restore(fixture.ledsP); //the effects continue on their own previous frame, not on the blended output
+        }
+        else
+          fixture.interpolator.end();
 
-      #ifdef STARLIGHT_USERMOD_WLEDAUDIO
+        #if !CONFIG_FREERTOS_UNICORE
+          if (parallel && renderTaskHandle == nullptr)
+            xTaskCreatePinnedToCore(renderTask, "render", 8192, this, 1, &renderTaskHandle, 1 - xPortGetCoreID()); //the core the loop is not running on
+        #endif
+
+        splitLayers();
 
-        if (mdl->getValue("viewRot")  == 4) {
-          fixture.head.x = wledAudioMod->fftResults[3];
-          fixture.head.y = wledAudioMod->fftResults[8];
-          fixture.head.z = wledAudioMod->fftResults[13];
+        #if !CONFIG_FREERTOS_UNICORE
+          if (!workerRows.empty()) { //the render task starts on its layers
+            loopTaskHandle = xTaskGetCurrentTaskHandle();
+            xTaskNotifyGive(renderTaskHandle);
+          }
+        #endif
+
+        for (unsigned8 rowNr: mainRows)
+          inTransition |= renderLayer(rowNr);
+
+        #if !CONFIG_FREERTOS_UNICORE
+          if (!workerRows.empty()) { //frame barrier: all layers rendered before show
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            inTransition |= workerInTransition;
+          }
+        #endif
+
+        //frame budget: rendering two effects per layer should not drop below transitionMinFps
+        if (inTransition && micros() - frameMicros > 1000000 / transitionMinFps) {
+          for (Leds *leds: fixture.listOfLeds)
+            leds->transition.shorten(sys->now);
         }
 
-      #endif
+        #ifdef STARLIGHT_USERMOD_WLEDAUDIO
+
+          if (mdl->getValue("viewRot")  == 4) {
+            fixture.head.x = wledAudioMod->fftResults[3];
+            fixture.head.y = wledAudioMod->fftResults[8];
+            fixture.head.z = wledAudioMod->fftResults[13];
+          }
 
-      if (fShow) {
-        #ifdef STARLIGHT_CLOCKLESS_LED_DRIVER
-          #if CONFIG_IDF_TARGET_ESP32S3 || CONFIG_IDF_TARGET_ESP32S2
-            if (driver.ledsbuff != NULL)
-              driver.show();
-          #else
-            if (driver.total_leds > 0)
-              driver.showPixels(WAIT);
-          #endif
-        #else
-          FastLED.show();
         #endif
-      }
 
-      frameCounter++;
+        #ifndef STARLIGHT_CLOCKLESS_LED_DRIVER
+          //start / stop here and not in onChange, so the show task never sends a buffer which is freed
+          if (pipeline != (fixture.showP != nullptr)) {
+            if (pipeline) startPipeline(); else stopPipeline();
+          }
+        #endif
+
+        //start / stop here and not in onChange, so the file does not change while a frame is written
+        if (record != fixture.recorder.isRecording()) {
+          if (record) {
+            char fileName[32];
+            print->fFormat(fileName, sizeof(fileName)-1, "/%s.slr", mdl->getValue("recordName").as<const char *>());
+            if (!fixture.recorder.begin(fileName, fixture.nrOfLeds, recordMaxKB * 1024)) record = false;
+          }
+          else
+            fixture.recorder.end();
+        }
+        if (!fixture.recorder.addFrame(fixture.ledsP, sys->now)) record = false; //stopped by itself, see stopReason
+
+        if (fixture.interpolator.isActive())
+          fixture.interpolator.addKeyframe(fixture.ledsP, 1000000 / fps);
+
+        renderMicros = micros() - frameMicros;
+
+        showFrame();
+
+        frameCounter++;
+
+        //layers showing a static effect remember what they rendered
+        for (Leds *leds: fixture.listOfLeds)
+          leds->staticHash = (!leds->doMap && leds->fx < effects.size() && effects[leds->fx]->isStatic())?leds->controlsHash():0;
+        frameChanged = false;
+        lastShowMillis = sys->now;
+        busyMicros += micros() - frameMicros;
+      }
+    }
+    else if (fixture.interpolator.isActive() && outputPacer.due(outputFps) && fixture.interpolator.output(fixture.ledsP)) {
+      //in between rendered frames: show a blend of the last two
+      unsigned long frameMicros = micros();
+      newFrame = true;
+      showFrame();
+      outputCounter++;
+      busyMicros += micros() - frameMicros + fixture.interpolator.blendMicros;
     }
     else {
       newFrame = false;
@@ -530,9 +970,11 @@ public:
     }
 
     //update projection
-    if (sys->now - lastMappingMillis >= 1000 && fixture.doMap) { //not more then once per second (for E131)
-      lastMappingMillis = sys->now;
+    if ((lastMappingMillis == 0 || sys->now - lastMappingMillis >= 1000) && fixture.doMap) { //not more then once per second (for E131), the first right away
+      unsigned long mapMicros = micros();
       fixture.projectAndMap();
+      if (lastMappingMillis == 0) mdls->bootPhase("first map", micros() - mapMicros);
+      lastMappingMillis = sys->now?sys->now:1; //0: not mapped yet
 
       //https://github.com/FastLED/FastLED/wiki/Multiple-Controller-Examples
 
@@ -541,6 +983,10 @@ public:
       if (fixture.doAllocPins) {
         unsigned pinNr = 0;
 
+        #ifndef STARLIGHT_CLOCKLESS_LED_DRIVER
+          stopPipeline(); //new controllers and nrOfLeds, started again in the next frame
+        #endif
+
         #ifdef STARLIGHT_CLOCKLESS_LED_DRIVER
           int pinAssignment[16]; //max 16 pins
           int lengths[16]; //max 16 pins
@@ -787,11 +1233,39 @@ public:
         fixture.doAllocPins = false;
       }
     }
+
+    //nothing to do until the next frame: give the cpu to other tasks (the loops of the other modules then run once per frame)
+    if (pacerSleep) {
+      int64_t sleepMicros = (fixture.interpolator.isActive()?min(pacer.untilNext(), outputPacer.untilNext()):pacer.untilNext()) - 1000; //wake up in time, ticks are 1 ms
+      if (sleepMicros >= 1000) vTaskDelay(sleepMicros / 1000 / portTICK_PERIOD_MS);
+    }
   } //loop
 
   void loop1s() {
     mdl->setUIValueV("realFps", "%lu /s", frameCounter);
+    mdl->setUIValueV("frameJitter", "p50:%u p95:%u p99:%u µs", pacer.percentile(50), pacer.percentile(95), pacer.percentile(99));
+    pacer.clearHistogram();
+    if (govern) {
+      if (governor.adjust(busyMicros, frameCounter + framesSkipped, fps)) governAll();
+      mdl->setUIValueV("govState", "p:%d i:%d s:%d n:%d %s", governor.divider(gov_Preview), governor.divider(gov_Interlace), governor.divider(gov_Scale), governor.divider(gov_Network), governor.lastChange);
+    }
+    mdl->setUIValueV("framesSkipped", "%lu /s", framesSkipped);
+    framesSkipped = 0;
+    mdl->setUIValueV("effectsIdle", "%d%%", 100 - min(busyMicros / 10000, (unsigned long)100));
+    busyMicros = 0;
+    modulators.sendSnapshot(); //modulated values change each frame, the UI once per second
+    mdl->setUIValueV("frameStages", "r:%lu s:%lu w:%lu µs", renderMicros, (unsigned long)showMicros, waitMicros);
+    if (fixture.recorder.isRecording())
+      mdl->setUIValueV("recordState", "%u frames %u KB", fixture.recorder.nrOfFrames, fixture.recorder.nrOfBytes / 1024);
+    else if (fixture.recorder.stopReason)
+      mdl->setUIValueV("recordState", "stopped: %s", fixture.recorder.stopReason);
+    if (fixture.playbackDecodeMicros)
+      mdl->setUIValueV("playbackFps", "%u /s", 1000000 / fixture.playbackDecodeMicros);
+    fixture.playbackDecodeMicros = 0;
+    if (fixture.interpolator.isActive()) //cost of blending vs rendering all output frames
+      mdl->setUIValueV("outputStats", "%lu /s blend:%u render:%lu µs", frameCounter + outputCounter, fixture.interpolator.blendMicros, renderMicros);
     frameCounter = 0;
+    outputCounter = 0;
   }
 
   void loop10s() {
@@ -800,9 +1274,250 @@ public:
     // trigoUnCached = 0;
   }
 
+  //network senders: send this frame (the governor can skip frames)
+  bool networkFrame() {return governor.networkFrame(frameCounter);}
+
+  //render mode and scale of a layer: the one set in the ui, or lower if the governor stepped down
+  void governLayer(unsigned8 rowNr) {
+    Leds *leds = fixture.listOfLeds[rowNr];
+
+    unsigned8 renderMode = mdl->getValue("render", rowNr);
+    unsigned8 fraction = governor.divider(gov_Interlace);
+    if (fraction > leds->renderFraction(renderMode))
+      renderMode = fraction == 2?r_Interlace2:r_Interlace4;
+    if (renderMode != leds->renderMode) {
+      leds->renderMode = renderMode;
+      leds->renderPhase = 0;
+    }
+
+    unsigned8 renderScale = max((unsigned8)(1 << min(mdl->getValue("scale", rowNr).as<unsigned8>(), (unsigned8)2)), governor.divider(gov_Scale));
+    if (renderScale != leds->renderScale) {
+      leds->renderScale = renderScale;
+      leds->fadeToBlackBy();
+      leds->triggerMapping();
+    }
+  }
+
+  void governAll() {
+    for (forUnsigned8 rowNr = 0; rowNr < fixture.listOfLeds.size(); rowNr++)
+      governLayer(rowNr);
+  }
+
 private:
-  unsigned long frameMillis = 0;
   unsigned long frameCounter = 0;
+  unsigned long outputCounter = 0; //blended frames
+  unsigned long framesSkipped = 0;
+  unsigned long busyMicros = 0; //rendering and showing in the current second
+  unsigned long lastShowMillis = 0;
+
+  unsigned long renderMicros = 0; //last frame: effects, transitions and recording
+  volatile unsigned long showMicros = 0; //last frame: sending the leds, set by the show task if pipelined
+  unsigned long waitMicros = 0; //last frame: waiting for the show task
+
+  //sends ledsP to the leds, pipelined if the show task runs
+  void showFrame() {
+    if (fShow) {
+      #ifndef STARLIGHT_CLOCKLESS_LED_DRIVER
+        if (fixture.showP) {
+          //pipelined: wait until the show task has sent the previous frame, hand over this frame and continue with the next
+          unsigned long waitStart = micros();
+          while (showBusy) delay(1);
+          waitMicros = micros() - waitStart;
+          memcpy(fixture.showP, fixture.ledsP, min(fixture.nrOfLeds, showNrOfLeds) * sizeof(CRGB));
+          showBusy = true;
+          xTaskNotifyGive(showTaskHandle);
+        }
+        else
+      #endif
+      {
+        unsigned long showStart = micros();
+        #ifdef STARLIGHT_CLOCKLESS_LED_DRIVER
+          #if CONFIG_IDF_TARGET_ESP32S3 || CONFIG_IDF_TARGET_ESP32S2
+            if (driver.ledsbuff != NULL)
+              driver.show();
+          #else
+            if (driver.total_leds > 0)
+              driver.showPixels(WAIT);
+          #endif
+        #else
+          FastLED.show();
+        #endif
+        showMicros = micros() - showStart;
+        waitMicros = 0;
+      }
+    }
+
+    //the first frame after the first mapping: the deferred modules can be set up now
+    if (!mdls->outputStarted && lastMappingMillis) {
+      mdls->outputStarted = true;
+      mdls->bootPhase("first show", showMicros);
+    }
+  }
+
+  std::vector<unsigned8> mainRows; //layers rendered by the loop this frame
+  std::vector<unsigned8> workerRows; //layers rendered by the render task this frame
+
+  //next frame of one layer, returns true if in transition
+  //  also runs on the render task: only uses the layer itself, its own physical leds and the (thread local) getValueRowNr
+  bool renderLayer(unsigned8 rowNr) {
+    Leds *leds = fixture.listOfLeds[rowNr];
+    unsigned long layerStart = micros();
+    // ppf(" %d %d,%d,%d - %d,%d,%d (%d,%d,%d)", leds->fx, leds->startPos.x, leds->startPos.y, leds->startPos.z, leds->endPos.x, leds->endPos.y, leds->endPos.z, leds->size.x, leds->size.y, leds->size.z );
+    mdl->getValueRowNr = rowNr;
+
+    leds->nextRenderPhase();
+
+    unsigned8 progress = 255;
+    if (leds->transition.fx < effects.size()) {
+      progress = leds->transition.progress(sys->now);
+      if (progress == 255) leds->endTransition(); //new effect continues on the mixed frame
+    }
+
+    //transition: the previous effect renders its own frame using its own effectData
+    if (progress < 255) {
+      leds->loadFrame(leds->transition.from);
+      leds->effectData.swap(leds->transition.effectData);
+      leds->effectData.begin();
+      if (!leds->effectData.failed()) effects[leds->transition.fx]->loop(*leds);
+      leds->effectData.swap(leds->transition.effectData);
+      leds->storeFrame(leds->transition.from);
+      leds->loadFrame(leds->transition.to);
+    }
+
+    leds->effectData.begin(); //sets the effectData pointer back to 0 so loop effect can go through it
+    if (!leds->effectData.failed()) effects[leds->fx]->loop(*leds); //out of memory: the effect would work on dummy values
+    leds->applyFade(); //fades not applied yet (e.g. nothing drawn after fadeToBlackBy), before other layers draw
+    #ifdef STARLIGHT_SHAREDDATA_GUARD
+      leds->effectData.checkGuards(effects.entry(leds->fx).name);
+    #endif
+
+    if (progress < 255) {
+      leds->storeFrame(leds->transition.to);
+      leds->mixTransition(transitionType, progress);
+    }
+
+    mdl->getValueRowNr = UINT8_MAX;
+    // if (leds->projectionNr == p_TiltPanRoll || leds->projectionNr == p_Preset1)
+    //   leds->fadeToBlackBy(50);
+    leds->renderMicros = micros() - layerStart;
+    return progress < 255;
+  }
+
+  //layers which share no physical leds with other layers can render on the render task, they go to the core with the least work (previous frame)
+  //  other layers render on the loop in their order, as they blend into each other
+  void splitLayers() {
+    mainRows.clear();
+    workerRows.clear();
+    unsigned long mainLoad = 0;
+    unsigned long workerLoad = 0;
+    for (forUnsigned8 rowNr = 0; rowNr < fixture.listOfLeds.size(); rowNr++) {
+      Leds *leds = fixture.listOfLeds[rowNr];
+      if (leds->doMap) continue; // don't run effect while remapping
+
+      bool independent = false;
+      #if !CONFIG_FREERTOS_UNICORE
+        if (parallel && renderTaskHandle) {
+          independent = leds->projectionNr != p_None && leds->projectionNr != p_Random; //these write anywhere in ledsP
+          for (Leds *other: fixture.listOfLeds)
+            if (other != leds && leds->overlaps(*other)) independent = false;
+        }
+      #endif
+
+      if (independent && workerLoad < mainLoad) {
+        workerRows.push_back(rowNr);
+        workerLoad += leds->renderMicros;
+      }
+      else {
+        mainRows.push_back(rowNr);
+        mainLoad += leds->renderMicros;
+      }
+    }
+  }
+
+  #if !CONFIG_FREERTOS_UNICORE
+    TaskHandle_t renderTaskHandle = nullptr;
+    TaskHandle_t loopTaskHandle = nullptr;
+    std::atomic<bool> workerInTransition = {false};
+
+    //renders workerRows each time the loop starts a frame, notifies the loop when done
+    static void renderTask(void *parameter) {
+      LedModEffects *self = (LedModEffects *)parameter;
+      for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        bool inTransition = false;
+        for (unsigned8 rowNr: self->workerRows)
+          inTransition |= self->renderLayer(rowNr);
+        self->workerInTransition = inTransition;
+        xTaskNotifyGive(self->loopTaskHandle);
+      }
+    }
+  #endif
+
+  #ifndef STARLIGHT_CLOCKLESS_LED_DRIVER
+    TaskHandle_t showTaskHandle = nullptr;
+    std::atomic<bool> showBusy = {false}; //set by the loop when a frame is handed over, cleared by the show task when it is sent
+    unsigned16 showNrOfLeds = 0; //size of fixture.showP
+
+    //sends fixture.showP each time the loop hands over a frame
+    static void showTask(void *parameter) {
+      LedModEffects *self = (LedModEffects *)parameter;
+      for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        unsigned long showStart = micros();
+        FastLED.show();
+        self->showMicros = micros() - showStart;
+        self->showBusy = false;
+      }
+    }
+
+    //controllers added on ledsP (addLeds) send from showP instead, or back
+    void pointControllers(CRGB *from, CRGB *to) {
+      for (int i = 0; i < FastLED.count(); i++) {
+        CLEDController &controller = FastLED[i];
+        int offset = controller.leds() - from;
+        if (offset >= 0 && offset + controller.size() <= showNrOfLeds)
+          controller.setLeds(to + offset, controller.size());
+      }
+    }
+
+    void startPipeline() {
+      showNrOfLeds = fixture.nrOfLeds;
+      fixture.showP = (CRGB *)calloc(showNrOfLeds, sizeof(CRGB));
+      if (fixture.showP == nullptr) {
+        ppf("startPipeline calloc %d leds failed\n", showNrOfLeds);
+        pipeline = false;
+        return;
+      }
+      if (showTaskHandle == nullptr) {
+        #if CONFIG_FREERTOS_UNICORE
+          BaseType_t core = 0;
+        #else
+          BaseType_t core = 1 - xPortGetCoreID(); //the core the loop is not running on
+        #endif
+        xTaskCreatePinnedToCore(showTask, "show", 4096, this, 3, &showTaskHandle, core);
+      }
+      pointControllers(fixture.ledsP, fixture.showP);
+      ppf("startPipeline %d leds\n", showNrOfLeds);
+    }
+
+    void stopPipeline() {
+      while (showBusy) delay(1);
+      if (fixture.showP == nullptr) return;
+      pointControllers(fixture.showP, fixture.ledsP);
+      free(fixture.showP);
+      fixture.showP = nullptr;
+      ppf("stopPipeline\n");
+    }
+  #endif
+
+  //true if all layers show a static effect and their controls did not change since the last rendered frame
+  bool isStaticFrame() {
+    if (!skipStatic || frameChanged || record || fixture.recorder.isRecording() || fixture.listOfLeds.empty()) return false;
+    if (keepAliveMs && sys->now - lastShowMillis >= keepAliveMs) return false; //refresh, e.g. for receivers which time out
+    for (Leds *leds: fixture.listOfLeds)
+      if (leds->doMap || leds->staticHash == 0 || leds->transition.fx < effects.size() || leds->staticHash != leds->controlsHash()) return false;
+    return true;
+  }
 
 };
 
@@ -50,6 +50,7 @@ public:
           FastLED.setBrightness(result);
         #endif
 
+        eff->frameChanged = true; //also show if the effects are static
         ppf("Set Brightness to %d -> b:%d r:%d\n", var["value"].as<int>(), bri, result);
         return true; }
       default: return false; 
@@ -64,7 +65,7 @@ public:
         // ui->setComment(var, "Click to enlarge");
         return true;
       case onLoop: {
-        var["interval"] =  max(eff->fixture.nrOfLeds * web->ws.count()/200, 16U)*10; //interval in ms * 10, not too fast //from cs to ms
+        var["interval"] =  max(eff->fixture.nrOfLeds * web->ws.count()/200, 16U)*10 * eff->governor.divider(gov_Preview); //interval in ms * 10, not too fast //from cs to ms, slower if the governor stepped down
 
         web->sendDataWs([this](AsyncWebSocketMessageBuffer * wsBuf) {
           byte* buffer;
@@ -192,6 +193,22 @@ public:
       default: return false; 
     }});
 
+    currentVar = ui->initNumber(parentVar, "outputFps", &eff->outputFps, 0, 999, false, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Output fps");
+        ui->setComment(var, "If higher than fps: blend between rendered frames (one frame delay)");
+        return true;
+      default: return false;
+    }});
+
+    ui->initText(currentVar, "outputStats", nullptr, 48, true, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Output");
+        ui->setComment(var, "frames, time per blended and per rendered frame");
+        return true;
+      default: return false;
+    }});
+
     ui->initText(parentVar, "realFps", nullptr, 10, true, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
       case onUI:
         web->addResponseV(var["id"], "comment", "f(%d leds)", eff->fixture.nrOfLeds);
@@ -199,6 +216,22 @@ public:
       default: return false;
     }});
 
+    ui->initText(parentVar, "frameJitter", nullptr, 48, true, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Jitter");
+        ui->setComment(var, "Frame interval vs 1/fps, last second");
+        return true;
+      default: return false;
+    }});
+
+    ui->initCheckBox(parentVar, "pacerSleep", &eff->pacerSleep, false, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onUI:
+        ui->setLabel(var, "Sleep");
+        ui->setComment(var, "Sleep until the next frame (other modules run once per frame)");
+        return true;
+      default: return false;
+    }});
+
     ui->initCheckBox(parentVar, "fShow", &eff->fShow, false, [this](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
       case onUI:
         #ifdef STARLIGHT_CLOCKLESS_LED_DRIVER
@@ -0,0 +1,126 @@
+/*
+   @title     StarLight
+   @file      LedModulators.h
+   @date      20240720
+   @repo      https://github.com/MoonModules/StarLight
+   @Authors   https://github.com/MoonModules/StarLight/commits/main
+   @Copyright © 2024 Github StarLight Commit Authors
+   @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+   @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+*/
+
+#pragma once
+#include "../Sys/SysModModel.h"
+#include "../Sys/SysModWeb.h"
+
+#ifdef STARLIGHT_USERMOD_WLEDAUDIO
+  #include "../User/UserModWLEDAudio.h"
+#endif
+#ifdef STARBASE_USERMOD_MPU6050
+  #include "../User/UserModMPU6050.h"
+#endif
+
+enum ModulatorSource {
+  mod_Sine,
+  mod_Saw,
+  mod_RandomWalk,
+  mod_Audio, //rate selects the band
+  mod_Gyro, //rate selects the axis
+  mod_count // keep as last entry
+};
+
+//modulates one effect control: the value is written directly in the control slot (effectData) of a layer
+//  the model is not changed (the control keeps its own value for saving), the UI gets snapshots in loop1s
+struct Modulator {
+  char varId[32] = ""; //effect control, e.g. speed
+  unsigned8 rowNr = 0; //layer (row in ledsTbl)
+  unsigned8 source = mod_Sine;
+  unsigned8 rate = 60; //bpm, random walk step, audio band or gyro axis
+  uint16_t min = 0;
+  uint16_t max = 255;
+
+  void *slot = nullptr; //uint8_t (range, select, checkbox) or uint16_t (number)
+  bool slot16 = false;
+  uint16_t value = 0; //last written value
+  uint8_t walk = 128; //random walk state
+};
+
+class Modulators {
+
+public:
+  std::vector<Modulator> list;
+
+  //modulator of a row in modTbl, added if not existing yet
+  Modulator *row(unsigned8 rowNr) {
+    if (rowNr == UINT8_MAX) return nullptr;
+    if (rowNr >= list.size()) list.resize(rowNr + 1);
+    needsBinding = true;
+    return &list[rowNr];
+  }
+
+  //control slots move when effectData is reallocated (effect change): resolve them again in the next loop
+  void unbind() {needsBinding = true;}
+
+  //writes all modulated values, only integer math
+  void loop() {
+    if (needsBinding) bind();
+
+    for (Modulator &mod: list) {
+      if (!mod.slot) continue;
+
+      uint8_t wave = 0; //0..255
+      switch (mod.source) {
+        case mod_Sine: wave = sin8(beat8(mod.rate, 0)); break;
+        case mod_Saw: wave = beat8(mod.rate, 0); break;
+        case mod_RandomWalk: {
+          int step = (int)random8(2 * (mod.rate / 16) + 1) - mod.rate / 16; //-rate/16..rate/16 per frame
+          mod.walk = constrain(mod.walk + step, 0, 255);
+          wave = mod.walk;
+          break; }
+        case mod_Audio:
+          #ifdef STARLIGHT_USERMOD_WLEDAUDIO
+            wave = wledAudioMod->fftResults[mod.rate % sizeof(wledAudioMod->fftResults)];
+          #endif
+          break;
+        case mod_Gyro:
+          #ifdef STARBASE_USERMOD_MPU6050
+            wave = (((mod.rate % 3 == 0)?mpu6050->gyro.x:(mod.rate % 3 == 1)?mpu6050->gyro.y:mpu6050->gyro.z) + 180) * 255 / 360; //degrees
+          #endif
+          break;
+      }
+
+      mod.value = mod.min + (mod.max - mod.min) * wave / 255;
+      if (mod.slot16)
+        *(uint16_t *)mod.slot = mod.value;
+      else
+        *(uint8_t *)mod.slot = mod.value;
+    }
+  }
+
+  //throttled: show the modulated values in the UI, without changing the model
+  void sendSnapshot() {
+    for (Modulator &mod: list)
+      if (mod.slot) web->addResponse(mod.varId, "value", mod.value, mod.rowNr);
+  }
+
+private:
+  bool needsBinding = true;
+
+  //find the control pointers once (findVar), not each frame
+  void bind() {
+    needsBinding = false;
+    for (Modulator &mod: list) {
+      mod.slot = nullptr;
+      if (strlen(mod.varId) == 0) continue;
+      JsonObject var = mdl->findVar(mod.varId);
+      if (var.isNull() || var["p"].isNull()) {
+        ppf("Modulator %s not found or not bound to a pointer\n", mod.varId);
+        continue;
+      }
+      int pointer = var["p"].is<JsonArray>()?var["p"][mod.rowNr]:var["p"];
+      mod.slot = (void *)pointer;
+      mod.slot16 = var["type"] == "number";
+      mod.value = mod.slot?(mod.slot16?*(uint16_t *)mod.slot:*(uint8_t *)mod.slot):0;
+    }
+  }
+};
@@ -0,0 +1,87 @@
+/*
+   @title     StarLight
+   @file      LedPacer.h
+   @date      20240720
+   @repo      https://github.com/MoonModules/StarLight
+   @Authors   https://github.com/MoonModules/StarLight/commits/main
+   @Copyright © 2024 Github StarLight Commit Authors
+   @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+   @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+*/
+
+#pragma once
+
+#ifdef ESP_PLATFORM
+  #include "esp_timer.h"
+#else
+  #include <chrono>
+#endif
+
+#define PACER_BUCKET_MICROS 50 //histogram resolution
+#define PACER_BUCKETS 64 //last bucket: 3.15 ms or more
+
+//microseconds since boot, 64 bits so it does not wrap (micros() wraps after 71 minutes)
+inline int64_t pacerMicros() {
+  #ifdef ESP_PLATFORM
+    return esp_timer_get_time();
+  #else
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); //host
+  #endif
+}
+
+//Frames on a fixed grid of 1000000 / fps microseconds: the next deadline is the previous deadline plus one period (not now plus one period), so frames do not drift
+//  the jitter (difference between frame interval and period) is counted in a histogram, read and cleared once per second
+class FramePacer {
+
+public:
+  //true if the next frame is due
+  bool due(unsigned16 fps) {
+    int64_t now = pacerMicros();
+    int64_t period = 1000000 / max(fps, (unsigned16)1);
+    if (period != this->period) { //fps changed: new grid starting now
+      this->period = period;
+      next = now;
+      last = 0;
+    }
+    if (now < next) return false;
+
+    if (last) {
+      int64_t jitter = now - last - period;
+      if (jitter < 0) jitter = -jitter;
+      histogram[min(jitter / PACER_BUCKET_MICROS, (int64_t)PACER_BUCKETS - 1)]++;
+      nrOfIntervals++;
+    }
+    last = now;
+
+    next += period;
+    if (now - next >= period) next = now + period; //more than a frame late (e.g. remapping): continue from now instead of a burst of catch up frames
+    return true;
+  }
+
+  //microseconds until the next frame, negative if late
+  int64_t untilNext() {return next - pacerMicros();}
+
+  //jitter percentile in microseconds (upper bound of the bucket), e.g. percentile(99)
+  unsigned32 percentile(unsigned8 percent) {
+    if (nrOfIntervals == 0) return 0;
+    unsigned32 target = (nrOfIntervals * percent + 99) / 100;
+    unsigned32 count = 0;
+    for (forUnsigned8 bucket = 0; bucket < PACER_BUCKETS; bucket++) {
+      count += histogram[bucket];
+      if (count >= target) return (bucket + 1) * PACER_BUCKET_MICROS;
+    }
+    return PACER_BUCKETS * PACER_BUCKET_MICROS;
+  }
+
+  void clearHistogram() {
+    memset(histogram, 0, sizeof(histogram));
+    nrOfIntervals = 0;
+  }
+
+private:
+  int64_t period = 0;
+  int64_t next = 0; //deadline of the next frame
+  int64_t last = 0; //start of the previous frame, 0 if none
+  unsigned16 histogram[PACER_BUCKETS] = {0};
+  unsigned32 nrOfIntervals = 0;
+};
@@ -0,0 +1,223 @@
+/*
+   @title     StarLight
+   @file      LedParticles.h
+   @date      20240720
+   @repo      https://github.com/MoonModules/StarLight
+   @Authors   https://github.com/MoonModules/StarLight/commits/main
+   @Copyright © 2024 Github StarLight Commit Authors
+   @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+   @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+*/
+
+#pragma once
+#include "LedLeds.h"
+
+#define PARTICLES_Max 2048
+#define PARTICLE_SHIFT 8 //fixed point: 8 fractional bits
+#define PARTICLE_ONE (1 << PARTICLE_SHIFT) //one pixel in fixed point
+
+//where and how particles are spawned
+struct ParticleEmitter {
+  Coord3D pos = {0,0,0};
+  int16_t vx = 0, vy = 0, vz = 0; //fixed point, pixels per step
+  unsigned8 spread = 0; //random velocity added per axis, 0..255 = 0..1 pixel per step
+  unsigned8 colorIndex = 0; //palette index
+  unsigned8 colorSpread = 0; //random palette index added
+};
+
+//Particle engine: fixed point state stored as struct of arrays in a SharedData (effectData) arena
+//  collisions use an occupancy bitmap per layer (1 bit per virtual pixel) so they do not depend on the (blended) ledsP framebuffer
+//  a Particles object is a view on the arena: bind it at the start of each effect loop, keep the same order as other effectData reads
+class Particles {
+
+public:
+  unsigned16 capacity = 0; //size of the arrays
+  unsigned16 *count; //active particles
+
+  int32_t *x, *y, *z; //position, fixed point
+  int16_t *vx, *vy, *vz; //velocity, fixed point, pixels per step
+  unsigned16 *cell; //occupied cell (XYZUnprojected index)
+  unsigned16 *prevCell; //cell at last render, UINT16_MAX if not drawn yet
+  unsigned8 *colorIndex; //palette index
+
+  byte *occupied; //particles and barriers
+  byte *barrier; //static obstacles, not cleared when particles move
+
+  int16_t *gravity; //3 values, fixed point, added to velocity each step
+
+  Particles(SharedData &data, unsigned16 capacity) {
+    this->capacity = min(capacity, (unsigned16)PARTICLES_Max);
+    count = data.readWrite<unsigned16>();
+    gravity = data.readWrite<int16_t>(3);
+    occupied = data.readWrite<byte>((NUM_VLEDS_Max + 7) / 8);
+    barrier = data.readWrite<byte>((NUM_VLEDS_Max + 7) / 8);
+    //32 bit arrays first to keep them aligned
+    x = data.readWrite<int32_t>(this->capacity);
+    y = data.readWrite<int32_t>(this->capacity);
+    z = data.readWrite<int32_t>(this->capacity);
+    vx = data.readWrite<int16_t>(this->capacity);
+    vy = data.readWrite<int16_t>(this->capacity);
+    vz = data.readWrite<int16_t>(this->capacity);
+    cell = data.readWrite<unsigned16>(this->capacity);
+    prevCell = data.readWrite<unsigned16>(this->capacity);
+    colorIndex = data.readWrite<unsigned8>(this->capacity);
+  }
+
+  //bytes used in SharedData for capacity particles (including alignment)
+  static size_t dataSize(unsigned16 capacity) {
+    return 8 + 2 * ((NUM_VLEDS_Max + 7) / 8) + 4 + capacity * (3 * sizeof(int32_t) + 3 * sizeof(int16_t) + 2 * sizeof(unsigned16) + sizeof(unsigned8)) + 8;
+  }
+
+  //remove all particles and barriers
+  void clear() {
+    *count = 0;
+    gravity[0] = gravity[1] = gravity[2] = 0;
+    memset(occupied, 0, (NUM_VLEDS_Max + 7) / 8);
+    memset(barrier, 0, (NUM_VLEDS_Max + 7) / 8);
+  }
+
+  //cells beyond the bitmap (layers larger than NUM_VLEDS_Max) count as barrier
+  bool isOccupied(unsigned32 index) {return index >= NUM_VLEDS_Max || ((occupied[index >> 3] >> (index & 7)) & 1);}
+
+  //marks the unmapped pixels of the layer as barrier, so particles stay on the fixture
+  void addUnmapped(Leds &leds) {
+    if (leds.mappingTable.size() == 0) return; //no projection: all pixels mapped
+    unsigned32 nrOfCells = leds.size.x * leds.size.y * leds.size.z;
+    for (forUnsigned16 index = 0; index < nrOfCells && index < NUM_VLEDS_Max; index++)
+      if (!leds.isMapped(index)) setBarrier(index);
+  }
+
+  void addBarrier(Leds &leds, Coord3D pos) {
+    if (!(pos >= 0 && pos < leds.size)) return;
+    unsigned32 index = cellIndex(leds, pos.x << PARTICLE_SHIFT, pos.y << PARTICLE_SHIFT, pos.z << PARTICLE_SHIFT);
+    if (index < NUM_VLEDS_Max) setBarrier(index);
+  }
+
+  //adds a particle if pos is free, returns false if not added
+  bool add(Leds &leds, Coord3D pos, int16_t vx, int16_t vy, int16_t vz, unsigned8 colorIndex) {
+    if (*count >= capacity) return false;
+    if (!(pos >= 0 && pos < leds.size)) return false;
+    unsigned32 index = cellIndex(leds, pos.x << PARTICLE_SHIFT, pos.y << PARTICLE_SHIFT, pos.z << PARTICLE_SHIFT);
+    if (isOccupied(index)) return false;
+    unsigned16 i = (*count)++;
+    x[i] = pos.x << PARTICLE_SHIFT;
+    y[i] = pos.y << PARTICLE_SHIFT;
+    z[i] = pos.z << PARTICLE_SHIFT;
+    this->vx[i] = vx;
+    this->vy[i] = vy;
+    this->vz[i] = vz;
+    cell[i] = index;
+    prevCell[i] = UINT16_MAX;
+    this->colorIndex[i] = colorIndex;
+    setOccupied(index, true);
+    return true;
+  }
+
+  //spawns up to amount particles from the emitter, returns the number added
+  unsigned16 emit(Leds &leds, const ParticleEmitter &emitter, unsigned16 amount = 1) {
+    unsigned16 added = 0;
+    for (forUnsigned16 i = 0; i < amount; i++) {
+      int16_t vx = emitter.vx + randomVelocity(leds, emitter.spread);
+      int16_t vy = emitter.vy + randomVelocity(leds, emitter.spread);
+      int16_t vz = (leds.size.z > 1)?emitter.vz + randomVelocity(leds, emitter.spread):0;
+      if (add(leds, emitter.pos, vx, vy, vz, emitter.colorIndex + (emitter.colorSpread?leds.rng.random8(emitter.colorSpread):0)))
+        added++;
+    }
+    return added;
+  }
+
+  //adds amount particles on random free pixels, returns the number added
+  unsigned16 scatter(Leds &leds, unsigned16 amount, unsigned8 spread = 255) {
+    unsigned16 added = 0;
+    for (forUnsigned16 i = 0; i < amount; i++) {
+      unsigned16 attempts = 0; //prevent infinite loop on small or full fixtures
+      while (attempts++ < 1000) {
+        Coord3D pos = {leds.rng.random16(leds.size.x), leds.rng.random16(leds.size.y), leds.rng.random16(leds.size.z)};
+        int16_t vz = (leds.size.z > 1)?randomVelocity(leds, spread):0;
+        if (add(leds, pos, randomVelocity(leds, spread), randomVelocity(leds, spread), vz, leds.rng.random8())) {
+          added++;
+          break;
+        }
+      }
+    }
+    return added;
+  }
+
+  //moves all particles one step: apply gravity, move at most one pixel per axis, bounce off edges, barriers and other particles
+  void step(Leds &leds) {
+    int32_t maxPos[3] = {(leds.size.x - 1) << PARTICLE_SHIFT, (leds.size.y - 1) << PARTICLE_SHIFT, (leds.size.z - 1) << PARTICLE_SHIFT};
+    for (forUnsigned16 i = 0; i < *count; i++) {
+      vx[i] = constrain(vx[i] + gravity[0], -PARTICLE_ONE, PARTICLE_ONE);
+      vy[i] = constrain(vy[i] + gravity[1], -PARTICLE_ONE, PARTICLE_ONE);
+      vz[i] = constrain(vz[i] + gravity[2], -PARTICLE_ONE, PARTICLE_ONE);
+
+      int32_t nx = x[i] + vx[i];
+      int32_t ny = y[i] + vy[i];
+      int32_t nz = z[i] + vz[i];
+
+      //edges: stay inside and bounce with damping
+      if (nx < 0 || nx > maxPos[0]) {vx[i] = -vx[i] / 2; nx = x[i];}
+      if (ny < 0 || ny > maxPos[1]) {vy[i] = -vy[i] / 2; ny = y[i];}
+      if (nz < 0 || nz > maxPos[2]) {vz[i] = -vz[i] / 2; nz = z[i];}
+
+      unsigned32 newCell = cellIndex(leds, nx, ny, nz);
+      if (newCell != cell[i] && isOccupied(newCell)) {
+        //blocked: slide along the free axes, bounce on the blocked ones
+        int32_t tx = x[i], ty = y[i], tz = z[i];
+        if (nx != x[i]) {if (isFree(i, cellIndex(leds, nx, ty, tz))) tx = nx; else vx[i] = -vx[i] / 2;}
+        if (ny != y[i]) {if (isFree(i, cellIndex(leds, tx, ny, tz))) ty = ny; else vy[i] = -vy[i] / 2;}
+        if (nz != z[i]) {if (isFree(i, cellIndex(leds, tx, ty, nz))) tz = nz; else vz[i] = -vz[i] / 2;}
+        nx = tx; ny = ty; nz = tz;
+        newCell = cellIndex(leds, nx, ny, nz);
+      }
+
+      x[i] = nx; y[i] = ny; z[i] = nz;
+      if (newCell != cell[i]) {
+        setOccupied(cell[i], false);
+        setOccupied(newCell, true);
+        cell[i] = newCell;
+      }
+    }
+  }
+
+  //draws all particles in one pass: erase the pixel a particle left (if not taken by another particle or barrier), draw the particle
+  void render(Leds &leds) {
+    for (forUnsigned16 i = 0; i < *count; i++) {
+      if (prevCell[i] != cell[i] && prevCell[i] < NUM_VLEDS_Max && !isOccupied(prevCell[i]))
+        leds.setPixelColor(cellToCoord(leds, prevCell[i]), CRGB::Black, 0);
+      leds.setPixelColor({x[i] >> PARTICLE_SHIFT, y[i] >> PARTICLE_SHIFT, z[i] >> PARTICLE_SHIFT}, ColorFromPalette(leds.palette, colorIndex[i]), 0);
+      prevCell[i] = cell[i];
+    }
+  }
+
+private:
+  void setOccupied(unsigned32 index, bool value) {
+    if (index >= NUM_VLEDS_Max || barrier[index >> 3] & (1 << (index & 7))) return; //barriers stay occupied
+    if (value)
+      occupied[index >> 3] |= (1 << (index & 7));
+    else
+      occupied[index >> 3] &= ~(1 << (index & 7));
+  }
+
+  //a cell is free for particle i if nobody else occupies it
+  bool isFree(unsigned16 i, unsigned32 index) {return index == cell[i] || !isOccupied(index);}
+
+  void setBarrier(unsigned32 index) {
+    barrier[index >> 3] |= (1 << (index & 7));
+    occupied[index >> 3] |= (1 << (index & 7));
+  }
+
+  //32 bit: does not wrap on large layers, isOccupied treats cells beyond the bitmap as barrier
+  unsigned32 cellIndex(Leds &leds, int32_t px, int32_t py, int32_t pz) {
+    return (px >> PARTICLE_SHIFT) + ((py >> PARTICLE_SHIFT) + (pz >> PARTICLE_SHIFT) * (unsigned32)leds.size.y) * leds.size.x;
+  }
+
+  Coord3D cellToCoord(Leds &leds, unsigned16 index) {
+    int xy = leds.size.x * leds.size.y;
+    return {index % leds.size.x, (index % xy) / leds.size.x, index / xy};
+  }
+
+  int16_t randomVelocity(Leds &leds, unsigned8 spread) {
+    return spread?((int16_t)leds.rng.random8(spread) - spread / 2) * 2:0; //-spread..spread in 1/256 pixels
+  }
+};
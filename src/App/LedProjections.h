@@ -12,17 +12,19 @@
 //should not contain variables/bytes to keep mem as small as possible!!
 
 class NoneProjection: public Projection {
-  const char * name() {return "None";}
-  //uint8_t dim() {return _1D;} // every projection should work for all D
-  const char * tags() {return "💫";}
+public:
+  static constexpr const char *name = "None";
+  //static constexpr uint8_t dim = _1D; // every projection should work for all D
+  static constexpr const char *tags = "💫";
 
   void controls(Leds &leds, JsonObject parentVar) {
   }
 }; //NoneProjection
 
 class DefaultProjection: public Projection {
-  const char * name() {return "Default";}
-  const char * tags() {return "💫";}
+public:
+  static constexpr const char *name = "Default";
+  static constexpr const char *tags = "💫";
 
   public:
 
@@ -131,8 +133,9 @@ class DefaultProjection: public Projection {
 }; //DefaultProjection
 
 class PinwheelProjection: public Projection {
-  const char * name() {return "Pinwheel";}
-  const char * tags() {return "💫";}
+public:
+  static constexpr const char *name = "Pinwheel";
+  static constexpr const char *tags = "💫";
 
   public:
 
@@ -246,8 +249,9 @@ class PinwheelProjection: public Projection {
 }; //PinwheelProjection
 
 class MultiplyProjection: public Projection {
-  const char * name() {return "Multiply";}
-  const char * tags() {return "💫";}
+public:
+  static constexpr const char *name = "Multiply";
+  static constexpr const char *tags = "💫";
 
   public:
 
@@ -303,8 +307,9 @@ class MultiplyProjection: public Projection {
 }; //MultiplyProjection
 
 class TiltPanRollProjection: public Projection {
-  const char * name() {return "TiltPanRoll";}
-  const char * tags() {return "💫";}
+public:
+  static constexpr const char *name = "TiltPanRoll";
+  static constexpr const char *tags = "💫";
 
   public:
 
@@ -369,8 +374,9 @@ class TiltPanRollProjection: public Projection {
 }; //TiltPanRollProjection
 
 class DistanceFromPointProjection: public Projection {
-  const char * name() {return "Distance ⌛";}
-  const char * tags() {return "💫";}
+public:
+  static constexpr const char *name = "Distance ⌛";
+  static constexpr const char *tags = "💫";
 
   public:
 
@@ -424,8 +430,9 @@ class DistanceFromPointProjection: public Projection {
 }; //DistanceFromPointProjection
 
 class Preset1Projection: public Projection {
-  const char * name() {return "Preset1";}
-  const char * tags() {return "💫";}
+public:
+  static constexpr const char *name = "Preset1";
+  static constexpr const char *tags = "💫";
 
   void setup(Leds &leds, Coord3D &sizeAdjusted, Coord3D &pixelAdjusted, Coord3D &midPosAdjusted, Coord3D &mapped, uint16_t &indexV) {
     adjustSizeAndPixel(leds, sizeAdjusted, pixelAdjusted, midPosAdjusted);
@@ -452,16 +459,18 @@ class Preset1Projection: public Projection {
 }; //Preset1Projection
 
 class RandomProjection: public Projection {
-  const char * name() {return "Random";}
-  const char * tags() {return "💫";}
+public:
+  static constexpr const char *name = "Random";
+  static constexpr const char *tags = "💫";
 
   void controls(Leds &leds, JsonObject parentVar) {
   }
 }; //RandomProjection
 
 class ReverseProjection: public Projection {
-  const char * name() {return "Reverse";}
-  const char * tags() {return "💡";}
+public:
+  static constexpr const char *name = "Reverse";
+  static constexpr const char *tags = "💡";
 
   public:
 
@@ -515,8 +524,9 @@ class ReverseProjection: public Projection {
 }; //ReverseProjection
 
 class MirrorProjection: public Projection {
-  const char * name() {return "Mirror";}
-  const char * tags() {return "💡";}
+public:
+  static constexpr const char *name = "Mirror";
+  static constexpr const char *tags = "💡";
 
   public:
 
@@ -578,8 +588,9 @@ class MirrorProjection: public Projection {
 }; //MirrorProjection
 
 class GroupingProjection: public Projection {
-  const char * name() {return "Grouping";}
-  const char * tags() {return "💡";}
+public:
+  static constexpr const char *name = "Grouping";
+  static constexpr const char *tags = "💡";
 
   public:
 
@@ -615,16 +626,18 @@ class GroupingProjection: public Projection {
 }; //GroupingProjection
 
 class SpacingProjection: public Projection {
-  const char * name() {return "Spacing WIP";}
-  const char * tags() {return "💡";}
+public:
+  static constexpr const char *name = "Spacing WIP";
+  static constexpr const char *tags = "💡";
 
   void controls(Leds &leds, JsonObject parentVar) {
   }
 }; //SpacingProjection
 
 class TransposeProjection: public Projection {
-  const char * name() {return "Transpose";}
-  const char * tags() {return "💡";}
+public:
+  static constexpr const char *name = "Transpose";
+  static constexpr const char *tags = "💡";
 
   public:
 
@@ -676,16 +689,18 @@ class TransposeProjection: public Projection {
 }; //TransposeProjection
 
 class KaleidoscopeProjection: public Projection {
-  const char * name() {return "Kaleidoscope WIP";}
-  const char * tags() {return "💫";}
+public:
+  static constexpr const char *name = "Kaleidoscope WIP";
+  static constexpr const char *tags = "💫";
 
   void controls(Leds &leds, JsonObject parentVar) {
   }
 }; //KaleidoscopeProjection
 
 class TestProjection: public Projection {
-  const char * name() {return "Test";}
-  const char * tags() {return "💡";}
+public:
+  static constexpr const char *name = "Test";
+  static constexpr const char *tags = "💡";
 
   void controls(Leds &leds, JsonObject parentVar) {
   }
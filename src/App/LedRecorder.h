@@ -0,0 +1,261 @@
+/*
+   @title     StarLight
+   @file      LedRecorder.h
+   @date      20240720
+   @repo      https://github.com/MoonModules/StarLight
+   @Authors   https://github.com/MoonModules/StarLight/commits/main
+   @Copyright © 2024 Github StarLight Commit Authors
+   @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+   @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+*/
+
+#pragma once
+#include "LedLeds.h"
+#include "../Sys/SysModFiles.h"
+
+//Recording file (.slr) of physical frames (ledsP)
+//  header: 'S','L','R','1', nrOfLeds (uint16), reserved (uint16)
+//  frame: ms since previous frame (uint16), payload length (uint16), payload
+//  payload: delta with the previous frame (first frame with black), until nrOfLeds pixels:
+//    op & 0x80: (op & 0x7F) + 1 pixels unchanged
+//    else: (op & 0x7F) + 1 pixels changed, followed by their rgb bytes
+#define RECORDING_HEADER_SIZE 8
+#define RECORDING_FRAME_HEADER_SIZE 4
+#define RECORDING_MAX_RUN 128
+
+class Recorder {
+
+public:
+  unsigned32 nrOfFrames = 0;
+  unsigned32 nrOfBytes = 0;
+  const char *stopReason = nullptr; //why the last recording stopped by itself, nullptr if stopped by end()
+
+  bool isRecording() {return file;}
+
+  //maxBytes: the recording stops before the file would exceed it
+  bool begin(const char * fileName, unsigned16 nrOfLeds, unsigned32 maxBytes = UINT32_MAX) {
+    end();
+    file = files->open(fileName, "w");
+    if (!file) {
+      ppf("Recorder could not create %s\n", fileName);
+      return false;
+    }
+    this->nrOfLeds = nrOfLeds;
+    this->maxBytes = maxBytes;
+    previous.assign(nrOfLeds, CRGB::Black);
+    nrOfFrames = 0;
+    nrOfBytes = 0;
+    lastMillis = 0;
+    stopReason = nullptr;
+    byte header[RECORDING_HEADER_SIZE] = {'S', 'L', 'R', '1', (byte)(nrOfLeds & 0xFF), (byte)(nrOfLeds >> 8), 0, 0};
+    if (!write(header, sizeof(header))) return false;
+    ppf("Recorder begin %s %d leds\n", fileName, nrOfLeds);
+    return true;
+  }
+
+  void end() {
+    if (!file) return;
+    file.close();
+    previous.clear(); previous.shrink_to_fit();
+    buffer.clear(); buffer.shrink_to_fit();
+    files->filesChanged = true;
+    ppf("Recorder end %d frames %d bytes\n", nrOfFrames, nrOfBytes);
+  }
+
+  //encodes ledsP as delta with the previous frame and writes it in one write
+  //  returns false if the recording stopped: short write (file system full) or maxBytes reached
+  bool addFrame(CRGB *ledsP, unsigned long now) {
+    if (!file) return true;
+    unsigned16 deltaMillis = nrOfFrames?min(now - lastMillis, (unsigned long)UINT16_MAX):0;
+    lastMillis = now;
+
+    buffer.resize(RECORDING_FRAME_HEADER_SIZE);
+    unsigned16 i = 0;
+    while (i < nrOfLeds) {
+      bool same = ledsP[i] == previous[i];
+      unsigned16 run = 1;
+      while (i + run < nrOfLeds && run < RECORDING_MAX_RUN && (ledsP[i + run] == previous[i + run]) == same) run++;
+      if (same)
+        buffer.push_back(0x80 | (run - 1));
+      else {
+        buffer.push_back(run - 1);
+        for (forUnsigned16 j = i; j < i + run; j++) {
+          buffer.push_back(ledsP[j].r);
+          buffer.push_back(ledsP[j].g);
+          buffer.push_back(ledsP[j].b);
+          previous[j] = ledsP[j];
+        }
+      }
+      i += run;
+    }
+
+    unsigned16 length = buffer.size() - RECORDING_FRAME_HEADER_SIZE;
+    buffer[0] = deltaMillis & 0xFF; buffer[1] = deltaMillis >> 8;
+    buffer[2] = length & 0xFF; buffer[3] = length >> 8;
+    if (!write(buffer.data(), buffer.size())) return false;
+    nrOfFrames++;
+    return true;
+  }
+
+private:
+  File file;
+  unsigned16 nrOfLeds = 0;
+  unsigned32 maxBytes = UINT32_MAX;
+  unsigned long lastMillis = 0;
+  std::vector<CRGB> previous;
+  std::vector<byte> buffer; //one encoded frame
+
+  //stops the recording if the data does not fit in maxBytes or is not written completely
+  bool write(const byte *data, size_t length) {
+    if (nrOfBytes + length > maxBytes) {
+      stop("size limit reached");
+      return false;
+    }
+    size_t written = file.write(data, length);
+    nrOfBytes += written;
+    if (written != length) {
+      stop("write failed (file system full?)"); //a partial frame at the end is skipped by the Player (frame corrupt)
+      return false;
+    }
+    return true;
+  }
+
+  void stop(const char *reason) {
+    ppf("Recorder stopped: %s\n", reason);
+    end();
+    stopReason = reason;
+  }
+};
+
+//streams a recording back with a read-ahead buffer, frames are shown at their recorded time
+class Player {
+
+public:
+  unsigned32 decodeMicros = 0; //average time to read and decode a frame
+
+  ~Player() {close();}
+
+  bool isPlaying() {return file;}
+
+  bool open(const char * fileName) {
+    close();
+    file = files->open(fileName, "r");
+    if (!file) {
+      ppf("Player could not open %s\n", fileName);
+      return false;
+    }
+    bufferLength = bufferPos = 0;
+    byte header[RECORDING_HEADER_SIZE];
+    if (!readBytes(header, sizeof(header)) || header[0] != 'S' || header[1] != 'L' || header[2] != 'R' || header[3] != '1') {
+      ppf("Player %s is not a recording\n", fileName);
+      close();
+      return false;
+    }
+    nrOfLeds = header[4] | (header[5] << 8);
+    frame.assign(nrOfLeds, CRGB::Black);
+    frameHeaderRead = false;
+    started = false;
+    decodeMicros = 0;
+    ppf("Player open %s %d leds\n", fileName, nrOfLeds);
+    return true;
+  }
+
+  void close() {
+    if (!file) return;
+    file.close();
+    frame.clear(); frame.shrink_to_fit();
+  }
+
+  //decodes the next frame if it is due and copies the current frame to ledsP
+  void loop(CRGB *ledsP, unsigned16 nrOfLedsP, unsigned long now) {
+    if (!file) return;
+    if (!started) {
+      nextMillis = now;
+      started = true;
+    }
+
+    if (!frameHeaderRead) {
+      if (!readFrameHeader()) { //end of the recording: start again
+        rewind();
+        if (!readFrameHeader()) {close(); return;} //no frames
+      }
+      nextMillis += deltaMillis;
+      if ((long)(now - nextMillis) > 1000) nextMillis = now; //more than a second behind: no catching up
+    }
+
+    if ((long)(now - nextMillis) >= 0) {
+      unsigned long startMicros = micros();
+      if (!readFramePayload()) {
+        ppf("Player frame corrupt, starting again\n");
+        rewind();
+      }
+      frameHeaderRead = false;
+      decodeMicros = decodeMicros?(decodeMicros * 7 + micros() - startMicros) / 8:micros() - startMicros;
+    }
+
+    memcpy(ledsP, frame.data(), min(nrOfLeds, nrOfLedsP) * sizeof(CRGB));
+  }
+
+private:
+  File file;
+  unsigned16 nrOfLeds = 0;
+  std::vector<CRGB> frame;
+  byte buffer[512]; //read-ahead
+  unsigned16 bufferLength = 0;
+  unsigned16 bufferPos = 0;
+  bool started = false;
+  bool frameHeaderRead = false;
+  unsigned16 deltaMillis = 0;
+  unsigned16 payloadLength = 0;
+  unsigned long nextMillis = 0;
+
+  bool readBytes(byte *dest, size_t length) {
+    while (length) {
+      if (bufferPos == bufferLength) {
+        bufferLength = file.read(buffer, sizeof(buffer));
+        bufferPos = 0;
+        if (bufferLength == 0) return false;
+      }
+      size_t chunk = min(length, (size_t)(bufferLength - bufferPos));
+      memcpy(dest, buffer + bufferPos, chunk);
+      bufferPos += chunk;
+      dest += chunk;
+      length -= chunk;
+    }
+    return true;
+  }
+
+  bool readFrameHeader() {
+    byte header[RECORDING_FRAME_HEADER_SIZE];
+    if (!readBytes(header, sizeof(header))) return false;
+    deltaMillis = header[0] | (header[1] << 8);
+    payloadLength = header[2] | (header[3] << 8);
+    frameHeaderRead = true;
+    return true;
+  }
+
+  bool readFramePayload() {
+    unsigned16 i = 0;
+    unsigned16 remaining = payloadLength;
+    while (i < nrOfLeds && remaining) {
+      byte op;
+      if (!readBytes(&op, 1)) return false;
+      remaining--;
+      unsigned16 run = (op & 0x7F) + 1;
+      if (i + run > nrOfLeds) return false;
+      if (!(op & 0x80)) {
+        if (run * 3 > remaining || !readBytes((byte *)&frame[i], run * 3)) return false; //CRGB is 3 bytes rgb
+        remaining -= run * 3;
+      }
+      i += run;
+    }
+    return remaining == 0;
+  }
+
+  void rewind() {
+    file.seek(RECORDING_HEADER_SIZE);
+    bufferLength = bufferPos = 0;
+    frameHeaderRead = false;
+    frame.assign(nrOfLeds, CRGB::Black);
+  }
+};
@@ -0,0 +1,61 @@
+/*
+   @title     StarLight
+   @file      LedRegistry.h
+   @date      20240720
+   @repo      https://github.com/MoonModules/StarLight
+   @Authors   https://github.com/MoonModules/StarLight/commits/main
+   @Copyright © 2024 Github StarLight Commit Authors
+   @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+   @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+*/
+
+#pragma once
+#include <vector>
+
+//one class in a registry (effect or projection): the factory and the metadata, so a table of entries is constant data (flash)
+//  name, tags and dim are static constexpr members of the class: no object is created to list the classes
+template<class Base>
+struct RegistryEntry {
+  Base *(*create)();
+  const char *name;
+  const char *tags;
+  uint8_t dim; //0 if Base has no dim
+};
+
+template<class Base, class T> Base *registryCreate() {return new T;}
+
+#define REGISTER_EFFECT(T) {registryCreate<Effect, T>, T::name, T::tags, T::dim}
+#define REGISTER_PROJECTION(T) {registryCreate<Projection, T>, T::name, T::tags, 0}
+
+//list of classes which creates an object only when it is used (e.g. the selected effect), not all of them at boot
+template<class Base>
+class Registry {
+
+public:
+  void begin(const RegistryEntry<Base> *entries, size_t count) {
+    this->entries = entries;
+    this->count = count;
+    objects.assign(count, nullptr);
+  }
+
+  size_t size() const {return count;}
+
+  const RegistryEntry<Base> &entry(size_t index) const {return entries[index];}
+
+  //the object of entry index, created when first used
+  Base *operator[](size_t index) {
+    if (objects[index] == nullptr) {
+      objects[index] = entries[index].create();
+      nrOfObjects++;
+    }
+    return objects[index];
+  }
+
+  size_t created() const {return nrOfObjects;}
+
+private:
+  const RegistryEntry<Base> *entries = nullptr;
+  size_t count = 0;
+  std::vector<Base *> objects; //nullptr if not created yet
+  size_t nrOfObjects = 0;
+};
@@ -16,18 +16,22 @@
 #include "SysModUI.h"
 #include "SysModInstances.h"
 
+thread_local unsigned8 SysModModel::getValueRowNr = UINT8_MAX;
+
 SysModModel::SysModModel() :SysModule("Model") {
   model = new JsonDocument(&allocator);
 
   JsonArray root = model->to<JsonArray>(); //create
 
   ppf("Reading model from /model.json... (deserializeConfigFromFS)\n");
+  unsigned long startMicros = micros();
   if (files->readObjectFromFile("/model.json", model)) {//not part of success...
     // print->printJson("Read model", *model);
     // web->sendDataWs(*model);
   } else {
     root = model->to<JsonArray>(); //re create the model as it is corrupted by readFromFile
   }
+  mdls->bootPhase("model.json", micros() - startMicros);
 }
 
 void SysModModel::setup() {
@@ -73,7 +77,7 @@ void SysModModel::setup() {
 
 void SysModModel::loop20ms() {
 
-  if (!cleanUpModelDone) { //do after all setups
+  if (!cleanUpModelDone && mdls->allSetup) { //do after all setups (including the deferred ones, see SysModules::add)
     cleanUpModelDone = true;
     cleanUpModel();
   }
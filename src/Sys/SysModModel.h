@@ -190,7 +190,7 @@ public:
   bool doWriteModel = false;
 
   unsigned8 setValueRowNr = UINT8_MAX;
-  unsigned8 getValueRowNr = UINT8_MAX;
+  static thread_local unsigned8 getValueRowNr; //per task, so tasks rendering different rows do not mix them up
 
   SysModModel();
   void setup();
@@ -147,6 +147,32 @@ void SysModWeb::setup() {
     default: return false;
   }});
 
+  ui->initText(parentVar, "wsOut", nullptr, 64, true, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+    case onUI:
+      ui->setLabel(var, "WS Out");
+      ui->setComment(var, "Waiting for busy clients and time handing over, per second");
+      return true;
+    default: return false;
+  }});
+
+  ui->initText(parentVar, "wsCommands", nullptr, 48, true, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+    case onUI:
+      ui->setLabel(var, "Commands");
+      ui->setComment(var, "Queue from web to loop, per second");
+      return true;
+    default: return false;
+  }});
+
+}
+
+void SysModWeb::loop() {
+  processCommands();
+
+  //messages for clients which were busy
+  if (!wsOutQueue.empty() && xSemaphoreTake(wsMutex, 0) == pdTRUE) {
+    flushWs();
+    xSemaphoreGive(wsMutex);
+  }
 }
 
 void SysModWeb::loop20ms() {
@@ -188,6 +214,16 @@ void SysModWeb::loop1s() {
   recvUDPCounter = 0;
   recvUDPBytes = 0;
 
+  mdl->setUIValueV("wsOut", "max queued: %d dropped: %d stalled: %d handoff: %u µs (max %u µs)", wsMaxQueued, wsFramesDropped, wsClientsStalled, wsHandoffMicros, wsHandoffMaxMicros);
+  wsMaxQueued = 0;
+  wsFramesDropped = 0;
+  wsClientsStalled = 0;
+  wsHandoffMicros = 0;
+  wsHandoffMaxMicros = 0;
+  mdl->setUIValueV("wsCommands", "max depth: %d dropped: %d coalesced: %d", cmdMaxDepth, cmdDropped.exchange(0), cmdCoalesced);
+  cmdMaxDepth = 0;
+  cmdCoalesced = 0;
+
   sendResponseObject(); //this sends all the loopTask responses once per second !!!
 }
 
@@ -250,36 +286,11 @@ void SysModWeb::wsEvent(WebSocket * ws, WebClient * client, AwsEventType type, v
   if (type == WS_EVT_CONNECT) {
     printClient("WS client connected", client);
 
-    //send system constants
-    getResponseObject()["sysInfo"]["board"] = CONFIG_IDF_TARGET;
-    getResponseObject()["sysInfo"]["nrOfPins"] = NUM_DIGITAL_PINS;
-    getResponseObject()["sysInfo"]["pinTypes"].to<JsonArray>();
-    JsonArray pinTypes = getResponseObject()["sysInfo"]["pinTypes"];
-    for (int i=0; i<NUM_DIGITAL_PINS; i++) {
-      pinTypes.add(pinsM->getPinType(i));
-    }
-
-    sendResponseObject(client);
-
-    JsonArray model = mdl->model->as<JsonArray>();
-
-    //inspired by https://github.com/bblanchon/ArduinoJson/issues/1280
-    //store arrayindex and sort order in vector
-    std::vector<ArrayIndexSortValue> aisvs;
-    size_t index = 0;
-    for (JsonObject moduleVar: model) {
-      ArrayIndexSortValue aisv;
-      aisv.index = index++;
-      aisv.value = mdl->varOrder(moduleVar);
-      aisvs.push_back(aisv);
-    }
-    //sort the vector by the order
-    std::sort(aisvs.begin(), aisvs.end(), [](const ArrayIndexSortValue &a, const ArrayIndexSortValue &b) {return a.value < b.value;});
-
-    //send model per module to stay under websocket size limit of 8192
-    for (const ArrayIndexSortValue &aisv : aisvs) {
-      sendDataWs(model[aisv.index], client); //send definition to client
-    }
+    //the model is sent by the loop task (it iterates the model)
+    WebCommand command;
+    command.type = cmd_Connect;
+    command.clientId = client->id();
+    if (!commands.push(command)) cmdDropped++;
 
     clientsChanged = true;
   } else if (type == WS_EVT_DISCONNECT) {
@@ -308,21 +319,17 @@ void SysModWeb::wsEvent(WebSocket * ws, WebClient * client, AwsEventType type, v
 
           DeserializationError error = deserializeJson(*responseDoc, data, len); //data to responseDoc
 
+          //answered here, on the web task which owns the clients: the loop task sends results by client id (sendDataWs)
           if (error || responseObject.isNull()) {
             ppf("wsEvent deserializeJson failed with code %s\n", error.c_str());
             client->text("{\"success\":true}"); // we have to send something back otherwise WS connection closes
-          } else {
-            bool isOnUI = !responseObject["onUI"].isNull();
-            ui->processJson(responseObject); //adds to responseDoc / responseObject
-
-            if (responseObject.size()) {
-              sendResponseObject(isOnUI?client:nullptr); //onUI only send to requesting client async response
-            }
-            else {
-              ppf("WS_EVT_DATA no responseDoc\n");
-              client->text("{\"success\":true}"); // we have to send something back otherwise WS connection closes
-            }
+          } else if (enqueueCommand(responseObject, client->id())) //processed by the loop task
+            client->text("{\"success\":true}"); // we have to send something back otherwise WS connection closes
+          else {
+            ppf("wsEvent command queue full\n");
+            client->text("{\"success\":false}"); // we have to send something back otherwise WS connection closes
           }
+          responseDoc->to<JsonObject>(); //queued as text, not needed anymore
         }
       }
     } else {
@@ -398,20 +405,28 @@ void SysModWeb::wsEvent(WebSocket * ws, WebClient * client, AwsEventType type, v
   }
 }
 
-void SysModWeb::sendDataWs(JsonVariant json, WebClient * client) {
+void SysModWeb::sendDataWs(JsonVariant json, unsigned32 clientId) {
 
   size_t len = measureJson(json);
   sendDataWs([json, len](AsyncWebSocketMessageBuffer * wsBuf) {
     serializeJson(json, wsBuf->get(), len);
-  }, len, false, client); //false -> text
+  }, len, false, clientId); //false -> text
 }
 
 //https://kcwong-joe.medium.com/passing-a-function-as-a-parameter-in-c-a132e69669f6
-void SysModWeb::sendDataWs(std::function<void(AsyncWebSocketMessageBuffer *)> fill, size_t len, bool isBinary, WebClient * client) {
-
-  xSemaphoreTake(wsMutex, portMAX_DELAY);
+//never waits for a client: messages for busy clients are queued per client (see WsOutMessage)
+void SysModWeb::sendDataWs(std::function<void(AsyncWebSocketMessageBuffer *)> fill, size_t len, bool isBinary, unsigned32 clientId) {
+
+  //only contends while serveUpload / serveUpdate send on the web task (see wsMutex), which holds it for one bounded handoff:
+  //  frames are skipped then (a newer frame follows), state changes wait
+  if (xSemaphoreTake(wsMutex, isBinary?0:portMAX_DELAY) != pdTRUE) {
+    wsFramesDropped++;
+    return;
+  }
 
+  unsigned long handoffStart = micros();
   ws.cleanupClients(); //only if above threshold
+  countHandoff(handoffStart);
 
   if (ws.count()) {
     if (len > 8192)
@@ -423,31 +438,44 @@ void SysModWeb::sendDataWs(std::function<void(AsyncWebSocketMessageBuffer *)> fi
 
       fill(wsBuf); //function parameter
 
+      WsOutMessage message = {wsBuf, len, isBinary};
       for (auto loopClient:ws.getClients()) {
-        if (!client || client == loopClient) {
-          if (loopClient->status() == WS_CONNECTED && !loopClient->queueIsFull()) { //WS_MAX_QUEUED_MESSAGES / ws.count() / 2)) { //binary is lossy
-            if (!isBinary || loopClient->queueLength() <= 3) {
-              isBinary?loopClient->binary(wsBuf): loopClient->text(wsBuf);
-              sendWsCounter++;
-              if (isBinary)
-                sendWsBBytes+=len;
-              else 
-                sendWsTBytes+=len;
-            }
-          }
-          else {
-            printClient("sendDataWs client full or not connected", loopClient);
-            // ppf("sendDataWs client full or not connected\n");
-            ws.cleanupClients(); //only if above threshold
-            ws._cleanBuffers();
+        if ((clientId && loopClient->id() != clientId) || loopClient->status() != WS_CONNECTED) continue;
+
+        //drop oldest: a frame still waiting for this client is replaced by this one
+        unsigned8 waiting = 0;
+        for (WsOutMessage &queued: wsOutQueue) {
+          auto it = std::find(queued.clientIds.begin(), queued.clientIds.end(), loopClient->id());
+          if (it == queued.clientIds.end()) continue;
+          if (isBinary && queued.isBinary) {
+            queued.clientIds.erase(it);
+            wsFramesDropped++;
           }
+          else
+            waiting++;
+        }
+
+        if (!isBinary && waiting >= WS_OUT_MAX_PER_CLIENT) {
+          printClient("sendDataWs client too slow, closing", loopClient);
+          loopClient->close(1013); //code 1013 = temporary overload, try again later
+          wsClientsStalled++;
+          continue;
         }
+        message.clientIds.push_back(loopClient->id());
       }
-      wsBuf->unlock();
-      ws._cleanBuffers();
+
+      if (message.clientIds.empty())
+        wsBuf->unlock();
+      else
+        wsOutQueue.push_back(message);
+      wsMaxQueued = max(wsMaxQueued, (unsigned8)min(wsOutQueue.size(), (size_t)UINT8_MAX));
+
+      flushWs();
     }
     else {
       ppf("sendDataWs WS buffer allocation failed\n");
+      for (WsOutMessage &queued: wsOutQueue) queued.wsBuf->unlock();
+      wsOutQueue.clear();
       ws.closeAll(1013); //code 1013 = temporary overload, try again later
       ws.cleanupClients(0); //disconnect ALL clients to release memory
       ws._cleanBuffers();
@@ -457,6 +485,49 @@ void SysModWeb::sendDataWs(std::function<void(AsyncWebSocketMessageBuffer *)> fi
   xSemaphoreGive(wsMutex);
 }
 
+void SysModWeb::flushWs() {
+  unsigned long handoffStart = micros();
+  bool budgetSpent = false; //the rest is sent by the next flushWs (SysModWeb::loop)
+  std::vector<unsigned32> busyIds; //a client which did not get a message does not get later messages either (keep the order)
+  for (auto message = wsOutQueue.begin(); message != wsOutQueue.end(); ) {
+    for (auto it = message->clientIds.begin(); it != message->clientIds.end(); ) {
+      WebClient *loopClient = ws.client(*it);
+      if (!loopClient || loopClient->status() != WS_CONNECTED) { //gone
+        it = message->clientIds.erase(it);
+        continue;
+      }
+      if (!budgetSpent) budgetSpent = micros() - handoffStart > WS_HANDOFF_MAX_MICROS;
+      if (budgetSpent || std::find(busyIds.begin(), busyIds.end(), *it) != busyIds.end() || loopClient->queueIsFull() || loopClient->queueLength() > WS_CLIENT_MAX_QUEUED) {
+        if (std::find(busyIds.begin(), busyIds.end(), *it) == busyIds.end()) busyIds.push_back(*it);
+        ++it;
+        continue;
+      }
+      message->isBinary?loopClient->binary(message->wsBuf): loopClient->text(message->wsBuf);
+      sendWsCounter++;
+      if (message->isBinary)
+        sendWsBBytes+=message->len;
+      else 
+        sendWsTBytes+=message->len;
+      it = message->clientIds.erase(it);
+    }
+
+    if (message->clientIds.empty()) { //sent to all: the clients keep the buffer until it is sent
+      message->wsBuf->unlock();
+      message = wsOutQueue.erase(message);
+    }
+    else
+      ++message;
+  }
+  ws._cleanBuffers();
+  countHandoff(handoffStart);
+}
+
+void SysModWeb::countHandoff(unsigned long start) {
+  unsigned32 spent = micros() - start;
+  wsHandoffMicros += spent;
+  wsHandoffMaxMicros = max(wsHandoffMaxMicros, spent);
+}
+
 //add an url to the webserver to listen to
 void SysModWeb::serveIndex(WebRequest *request) {
 
@@ -590,30 +661,207 @@ void SysModWeb::jsonHandler(WebRequest *request, JsonVariant json) {
 
   print->printJson("jsonHandler", json);
 
-  JsonObject responseObject = getResponseObject();
-
-  ui->processJson(json);
-
   //WLED compatibility
   if (json["v"]) { //WLED compatibility: verbose response
-    serveJson (request); //includes values just updated by processJson e.g. Bri
+    if (enqueueCommand(json, 0))
+      serveJson (request); //queued after the update, so values after this update
+    else
+      request->send(503, "application/json", F("{\"success\":false}"));
+    return;
   }
-  else {
-  
-    if (responseObject.size()) { //responseObject set by processJson e.g. onUI
 
-      char resStr[200];
-      serializeJson(responseObject, resStr, 200);
-      ppf("processJsonUrl response %s\n", resStr);
-      request->send(200, "application/json", resStr);
+  //processed by the loop task: the response waits for the result of processJson (e.g. onUI) without blocking the web task
+  std::shared_ptr<JsonSnapshot> snapshot = std::make_shared<JsonSnapshot>();
+  snapshot->type = json_Response;
+  if (enqueueCommand(json, 0, snapshot))
+    sendSnapshot(request, snapshot);
+  else
+    request->send(503, "application/json", F("{\"success\":false}"));
+}
+
+bool SysModWeb::enqueueCommand(JsonVariant json, unsigned32 clientId, std::shared_ptr<JsonSnapshot> snapshot) {
+  WebCommand command;
+  command.clientId = clientId;
+  command.snapshot = snapshot;
+  command.isOnUI = !json["onUI"].isNull();
+
+  //one var update (not a command): can be replaced by a later update of the same var
+  JsonObject object = json.as<JsonObject>();
+  if (object.size() == 1) {
+    const char *key = object.begin()->key().c_str();
+    bool isCommand = false;
+    for (const char *commandKey: {"v", "view", "canvasData", "theme", "addRow", "delRow", "onUI"})
+      isCommand |= strcmp(key, commandKey) == 0;
+    if (!isCommand) strlcpy(command.varKey, key, sizeof(command.varKey));
+  }
 
+  size_t length = measureJson(json) + 1;
+  command.json = (char *)malloc(length);
+  if (command.json == nullptr) {
+    cmdDropped++;
+    return false;
+  }
+  serializeJson(json, command.json, length);
+
+  if (!commands.push(command)) {
+    free(command.json);
+    cmdDropped++;
+    return false;
+  }
+  return true;
+}
+
+void SysModWeb::processCommands() {
+  size_t depth = commands.depth();
+  if (depth == 0) return;
+  cmdMaxDepth = max(cmdMaxDepth, (unsigned8)depth);
+
+  size_t count = 0;
+  while (count < WEB_COMMAND_QUEUE_SIZE && commands.pop(batch[count])) count++;
+
+  for (size_t i = 0; i < count; i++) {
+    WebCommand &command = batch[i];
+
+    if (command.type == cmd_Connect) {
+      sendModel(command.clientId);
+      continue;
     }
-    else
-      // request->send(200, "text/plain", "OK");
-      request->send(200, "application/json", F("{\"success\":true}"));
+
+    if (command.type == cmd_Serve) {
+      serializeSnapshot(*command.snapshot);
+      command.snapshot.reset(); //the response keeps it until it is sent
+      continue;
+    }
+
+    //a later update of the same var in this batch: skip this one (buttons excepted, each press counts)
+    if (command.varKey[0]) {
+      bool replaced = false;
+      for (size_t j = i + 1; j < count && !replaced; j++)
+        replaced = batch[j].type == cmd_Json && strcmp(batch[j].varKey, command.varKey) == 0;
+      if (replaced) {
+        char varId[32];
+        strlcpy(varId, command.varKey, sizeof(varId));
+        strtok(varId, "#");
+        if (mdl->findVar(varId)["type"] != "button") {
+          cmdCoalesced++;
+          free(command.json);
+          if (command.snapshot) storeSnapshot(*command.snapshot, "{\"success\":true}"); //http: replaced by a later update
+          command.snapshot.reset();
+          continue;
+        }
+      }
+    }
+
+    sendResponseObject(); //responses of the loop task so far, the response doc is reused for this command
+
+    JsonDocument *responseDoc = getResponseDoc();
+    JsonObject responseObject = getResponseObject();
+    DeserializationError error = deserializeJson(*responseDoc, command.json);
+    free(command.json);
+    if (error || responseObject.isNull()) { //should not happen, was valid json in enqueueCommand
+      ppf("processCommands deserializeJson failed with code %s\n", error.c_str());
+      responseDoc->to<JsonObject>();
+      if (command.snapshot) storeSnapshot(*command.snapshot, "{\"success\":false}");
+      command.snapshot.reset();
+      continue;
+    }
+
+    ui->processJson(responseObject); //adds to responseDoc / responseObject
+
+    //http: the result is the response (e.g. onUI), the response keeps the snapshot until it is sent
+    if (command.snapshot) {
+      if (responseObject.size())
+        storeSnapshot(*command.snapshot, responseObject);
+      else
+        storeSnapshot(*command.snapshot, "{\"success\":true}");
+      command.snapshot.reset();
+    }
+
+    if (responseObject.size())
+      sendResponseObject(command.isOnUI?command.clientId:0); //onUI only send to requesting client
   }
+}
+
+void SysModWeb::sendModel(unsigned32 clientId) {
+  sendResponseObject(); //responses of the loop task so far are for all clients
+
+  //send system constants
+  getResponseObject()["sysInfo"]["board"] = CONFIG_IDF_TARGET;
+  getResponseObject()["sysInfo"]["nrOfPins"] = NUM_DIGITAL_PINS;
+  getResponseObject()["sysInfo"]["pinTypes"].to<JsonArray>();
+  JsonArray pinTypes = getResponseObject()["sysInfo"]["pinTypes"];
+  for (int i=0; i<NUM_DIGITAL_PINS; i++) {
+    pinTypes.add(pinsM->getPinType(i));
+  }
+
+  sendResponseObject(clientId);
+
+  JsonArray model = mdl->model->as<JsonArray>();
 
-  sendResponseObject();
+  //inspired by https://github.com/bblanchon/ArduinoJson/issues/1280
+  //store arrayindex and sort order in vector
+  std::vector<ArrayIndexSortValue> aisvs;
+  size_t index = 0;
+  for (JsonObject moduleVar: model) {
+    ArrayIndexSortValue aisv;
+    aisv.index = index++;
+    aisv.value = mdl->varOrder(moduleVar);
+    aisvs.push_back(aisv);
+  }
+  //sort the vector by the order
+  std::sort(aisvs.begin(), aisvs.end(), [](const ArrayIndexSortValue &a, const ArrayIndexSortValue &b) {return a.value < b.value;});
+
+  //send model per module to stay under websocket size limit of 8192
+  for (const ArrayIndexSortValue &aisv : aisvs) {
+    sendDataWs(model[aisv.index], clientId); //send definition to client
+  }
+}
+
+void SysModWeb::serializeSnapshot(JsonSnapshot &snapshot) {
+  JsonDocument doc;
+  JsonVariant root;
+  if (snapshot.type == json_Model)
+    root = mdl->model->as<JsonVariant>(); //serialized as is, no copy
+  else {
+    JsonObject object = doc.to<JsonObject>();
+    switch (snapshot.type) {
+      case json_Perf:
+        mdls->perfToJson(object);
+        break;
+      case json_State:
+        serializeState(object);
+        break;
+      case json_Info:
+        serializeInfo(object);
+        break;
+      default:
+        //temporary set all WLED variables (as otherwise WLED-native does not show the instance): tbd: clean up (state still needed, info not)
+        serializeState(object["state"].to<JsonObject>());
+        serializeInfo(object["info"].to<JsonObject>());
+        break;
+    }
+    root = object;
+  }
+
+  storeSnapshot(snapshot, root);
+}
+
+void SysModWeb::storeSnapshot(JsonSnapshot &snapshot, JsonVariant json) {
+  snapshot.length = measureJson(json);
+  snapshot.json = (char *)malloc(snapshot.length + 1);
+  if (snapshot.json)
+    serializeJson(json, snapshot.json, snapshot.length + 1);
+  else {
+    ppf("storeSnapshot no memory for %d bytes\n", snapshot.length);
+    snapshot.length = 0;
+  }
+  snapshot.ready.store(true, std::memory_order_release); //after json and length: the web task can send
+}
+
+void SysModWeb::storeSnapshot(JsonSnapshot &snapshot, const char *json) {
+  snapshot.json = strdup(json);
+  snapshot.length = snapshot.json?strlen(json):0;
+  snapshot.ready.store(true, std::memory_order_release); //after json and length: the web task can send
 }
 
 void SysModWeb::clientsToJson(JsonArray array, bool nameOnly, const char * filter) {
@@ -661,7 +909,7 @@ JsonObject SysModWeb::getResponseObject() {
   return getResponseDoc()->as<JsonObject>();
 }
 
-void SysModWeb::sendResponseObject(WebClient * client) {
+void SysModWeb::sendResponseObject(unsigned32 clientId) {
   JsonObject responseObject = getResponseObject();
   if (responseObject.size()) {
     // if (strncmp(pcTaskGetTaskName(NULL), "loopTask", 8) != 0) {
@@ -682,7 +930,7 @@ void SysModWeb::sendResponseObject(WebClient * client) {
     //   }
     //   ppf("\n");
     // }
-    sendDataWs(responseObject, client);
+    sendDataWs(responseObject, clientId);
     getResponseDoc()->to<JsonObject>(); //recreate!
   }
 }
@@ -721,37 +969,39 @@ void SysModWeb::serializeInfo(JsonObject root) {
 }
 
 void SysModWeb::serveJson(WebRequest *request) {
-
-  AsyncJsonResponse * response;
-
-  // return model.json
-  if (request->url().indexOf("mdl") > 0) {
-    JsonArray model = mdl->model->as<JsonArray>();
-    ppf("serveJson model ...%d, %s %d %d\n", request->client()->remoteIP()[3], request->url().c_str(), model.size(),  measureJson(model));
-
-    response = new AsyncJsonResponse(true); //array, removed size as ArduinoJson v7 doesnt care (tbd: here copy is mode, see WLED for using reference)
-    JsonArray root = response->getRoot();
-
-    root.set(model);
-  } else { //WLED compatible
-    ppf("serveJson ...%d, %s\n", request->client()->remoteIP()[3], request->url().c_str());
-    response = new AsyncJsonResponse(false); //object. removed size as ArduinoJson v7 doesnt care
-    JsonObject root = response->getRoot();
-
-    //temporary set all WLED variables (as otherwise WLED-native does not show the instance): tbd: clean up (state still needed, info not)
-
-    if (request->url().indexOf("state") > 0) {
-      serializeState(root);
-    }
-    else if (request->url().indexOf("info") > 0) {
-      serializeInfo(root);
-    }
-    else {
-      serializeState(root["state"].to<JsonObject>());
-      serializeInfo(root["info"].to<JsonObject>());
-    }
+  //the model and the modules are only read by the loop task: it serializes a snapshot, the response waits for it without blocking the web task
+  std::shared_ptr<JsonSnapshot> snapshot = std::make_shared<JsonSnapshot>();
+  if (request->url().indexOf("mdl") > 0) // return model.json
+    snapshot->type = json_Model;
+  else if (request->url().indexOf("perf") > 0) //time spent per module callback
+    snapshot->type = json_Perf;
+  else if (request->url().indexOf("state") > 0) //WLED compatible
+    snapshot->type = json_State;
+  else if (request->url().indexOf("info") > 0)
+    snapshot->type = json_Info;
+  else
+    snapshot->type = json_All;
+  ppf("serveJson ...%d, %s\n", request->client()->remoteIP()[3], request->url().c_str());
+
+  WebCommand command;
+  command.type = cmd_Serve;
+  command.snapshot = snapshot;
+  if (!commands.push(command)) {
+    cmdDropped++;
+    request->send(503, "application/json", F("{\"success\":false}"));
+    return;
   }
 
-  response->setLength();
-  request->send(response);
-} //serveJson
\ No newline at end of file
+  sendSnapshot(request, snapshot);
+} //serveJson
+
+void SysModWeb::sendSnapshot(WebRequest *request, std::shared_ptr<JsonSnapshot> snapshot) {
+  //chunked as the length is not known yet: RESPONSE_TRY_AGAIN until the loop task is done (retried on the next ack or poll)
+  request->send(request->beginChunkedResponse("application/json", [snapshot](byte *buffer, size_t maxLen, size_t index) -> size_t {
+    if (!snapshot->ready.load(std::memory_order_acquire)) return RESPONSE_TRY_AGAIN;
+    if (index >= snapshot->length) return 0; //done
+    size_t len = min(maxLen, snapshot->length - index);
+    memcpy(buffer, snapshot->json + index, len);
+    return len;
+  }));
+}
\ No newline at end of file
@@ -12,6 +12,9 @@
 #pragma once
 #include "SysModule.h"
 #include "SysModPrint.h"
+#include "SysSpscQueue.h"
+#include <deque>
+#include <memory>
 
 #ifdef STARBASE_USE_Psychic
   #include <PsychicHttp.h>
@@ -34,6 +37,55 @@
   #define WebResponse AsyncWebServerResponse
 #endif
 
+enum WebCommandTypes {
+  cmd_Json, //var updates and commands (onUI, addRow, ...)
+  cmd_Connect, //new websocket client: send the model
+  cmd_Serve //http request for json (see serveJson): serialize a snapshot
+};
+
+enum JsonServeTypes {
+  json_Model,
+  json_Perf,
+  json_State, //WLED compatible
+  json_Info, //WLED compatible
+  json_All, //WLED compatible: state and info
+  json_Response //result of a POST /json (see jsonHandler)
+};
+
+//json serialized by the loop task for a response of the web task, shared by both: freed by whichever is done last
+struct JsonSnapshot {
+  unsigned8 type = json_All;
+  char *json = nullptr; //malloc'ed by the loop task
+  size_t length = 0;
+  std::atomic<bool> ready{false}; //set by the loop task after json and length are written
+
+  ~JsonSnapshot() {free(json);}
+};
+
+//a message received by the web task (websocket or http), processed by the loop task (see processCommands)
+struct WebCommand {
+  unsigned8 type = cmd_Json;
+  char *json = nullptr; //malloc'ed, freed by the loop task
+  unsigned32 clientId = 0; //0: http
+  bool isOnUI = false;
+  char varKey[32] = ""; //set if the message only updates one var (id or id#rowNr): an update of the same var later in the queue replaces it
+  std::shared_ptr<JsonSnapshot> snapshot; //cmd_Serve, and cmd_Json from http: filled with the response
+};
+
+#define WEB_COMMAND_QUEUE_SIZE 32
+
+//a websocket message waiting for clients which are busy (their AsyncTCP queue is filling up)
+struct WsOutMessage {
+  AsyncWebSocketMessageBuffer *wsBuf; //locked while queued, so not freed by _cleanBuffers
+  size_t len;
+  bool isBinary; //frame (e.g. pview): a newer frame replaces it, text (state change) is never replaced
+  std::vector<unsigned32> clientIds; //clients it is not sent to yet
+};
+
+#define WS_OUT_MAX_PER_CLIENT 8 //state changes waiting per client, more: the client is too slow and is closed (it gets the model again after reconnecting)
+#define WS_CLIENT_MAX_QUEUED 3 //hand over to a client while its AsyncTCP queue is shorter
+#define WS_HANDOFF_MAX_MICROS 2000 //time per flushWs for handing over to clients, the rest waits for the next loop
+
 class SysModWeb:public SysModule {
 
 public:
@@ -45,6 +97,8 @@ public:
     WebServer server = WebServer(80);
   #endif
 
+  //serializes the senders: the loop task and serveUpload / serveUpdate, which send their response on the web task
+  //  AsyncTCP does not take it, so it never waits for a client
   SemaphoreHandle_t wsMutex = xSemaphoreCreateMutex();
 
   unsigned8 sendWsCounter = 0;
@@ -56,6 +110,14 @@ public:
   unsigned16 sendUDPBytes = 0;
   unsigned8 recvUDPCounter = 0;
   unsigned16 recvUDPBytes = 0;
+  std::atomic<unsigned16> cmdDropped{0}; //queue full or no memory, incremented by the web task
+  unsigned16 cmdCoalesced = 0;
+  unsigned8 cmdMaxDepth = 0;
+  unsigned16 wsFramesDropped = 0; //replaced by a newer frame or wsMutex busy
+  unsigned16 wsClientsStalled = 0;
+  unsigned32 wsHandoffMicros = 0; //in cleanupClients, text / binary and _cleanBuffers, the time sending costs the loop
+  unsigned32 wsHandoffMaxMicros = 0; //longest single handoff
+  unsigned8 wsMaxQueued = 0;
 
   #ifdef STARBASE_USERMOD_LIVE
     char lastFileUpdated[30] = ""; //workaround!
@@ -64,6 +126,7 @@ public:
   SysModWeb();
 
   void setup();
+  void loop();
   void loop20ms();
   void loop1s();
 
@@ -73,9 +136,9 @@ public:
 
   void wsEvent(WebSocket * ws, WebClient * client, AwsEventType type, void * arg, byte *data, size_t len);
   
-  //send json to client or all clients
-  void sendDataWs(JsonVariant json = JsonVariant(), WebClient * client = nullptr);
-  void sendDataWs(std::function<void(AsyncWebSocketMessageBuffer *)> fill, size_t len, bool isBinary, WebClient * client = nullptr);
+  //send json to client or all clients (clientId 0), by id: a client pointer is only safe on the web task
+  void sendDataWs(JsonVariant json = JsonVariant(), unsigned32 clientId = 0);
+  void sendDataWs(std::function<void(AsyncWebSocketMessageBuffer *)> fill, size_t len, bool isBinary, unsigned32 clientId = 0);
 
   //add an url to the webserver to listen to
   void serveIndex(WebRequest *request);
@@ -84,6 +147,8 @@ public:
   void serializeState(JsonObject root);
   void serializeInfo(JsonObject root);
   void serveJson(WebRequest *request);
+  //chunked response which waits (without blocking) until the loop task has filled the snapshot
+  void sendSnapshot(WebRequest *request, std::shared_ptr<JsonSnapshot> snapshot);
 
 
   // curl -F 'data=@fixture1.json' 192.168.8.213/upload
@@ -155,7 +220,7 @@ public:
   //gets the right responseDoc, depending on which task you are in, alternative for requestJSONBufferLock
   JsonDocument * getResponseDoc();
   JsonObject getResponseObject();
-  void sendResponseObject(WebClient * client = nullptr);
+  void sendResponseObject(unsigned32 clientId = 0);
 
   void printClient(const char * text, WebClient * client) {
     ppf("%s client: %d ...%d q:%d l:%d s:%d (#:%d)\n", text, client?client->id():-1, client?client->remoteIP()[3]:-1, client->queueIsFull(), client->queueLength(), client->status(), client->server()->count());
@@ -165,6 +230,29 @@ public:
 private:
   bool modelUpdated = false;
 
+  //web task to loop task: the model, ui and leds are only changed by the loop task
+  SpscQueue<WebCommand, WEB_COMMAND_QUEUE_SIZE> commands;
+  WebCommand batch[WEB_COMMAND_QUEUE_SIZE]; //commands drained in one loop
+
+  std::deque<WsOutMessage> wsOutQueue; //oldest first, only used with wsMutex taken
+
+  //send queued messages to clients which are not busy, with wsMutex taken
+  //  stops after WS_HANDOFF_MAX_MICROS
+  void flushWs();
+  void countHandoff(unsigned long start);
+
+  //web task: false if the queue is full, snapshot: gets the response (http)
+  bool enqueueCommand(JsonVariant json, unsigned32 clientId, std::shared_ptr<JsonSnapshot> snapshot = nullptr);
+  //loop task: all queued commands, updates of the same var coalesced
+  void processCommands();
+  //loop task: system info and the model definition to a new client
+  void sendModel(unsigned32 clientId);
+  //loop task: serializes what a json request asked for
+  void serializeSnapshot(JsonSnapshot &snapshot);
+  //loop task: json to the snapshot, after this the web task sends it
+  void storeSnapshot(JsonSnapshot &snapshot, JsonVariant json);
+  void storeSnapshot(JsonSnapshot &snapshot, const char *json);
+
   bool clientsChanged = false;
 
   JsonDocument *responseDocLoopTask = nullptr;
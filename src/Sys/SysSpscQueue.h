@@ -0,0 +1,49 @@
+/*
+   @title     StarBase
+   @file      SysSpscQueue.h
+   @date      20240720
+   @repo      https://github.com/ewowi/StarBase, submit changes to this file as PRs to ewowi/StarBase
+   @Authors   https://github.com/ewowi/StarBase/commits/main
+   @Copyright © 2024 Github StarBase Commit Authors
+   @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+   @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+*/
+
+#pragma once
+#include <atomic>
+
+//Bounded single producer / single consumer queue without locks: one task pushes, one other task pops
+//  head is only written by the consumer, tail only by the producer, Size must be a power of 2
+template<typename T, size_t Size>
+class SpscQueue {
+  static_assert((Size & (Size - 1)) == 0, "SpscQueue Size must be a power of 2");
+
+public:
+  //producer: false if full (the item is not added)
+  bool push(const T &item) {
+    size_t tail = this->tail.load(std::memory_order_relaxed);
+    if (tail - head.load(std::memory_order_acquire) == Size) return false;
+    items[tail & (Size - 1)] = item;
+    this->tail.store(tail + 1, std::memory_order_release); //the item is written before the consumer sees it
+    return true;
+  }
+
+  //consumer: false if empty
+  bool pop(T &item) {
+    size_t head = this->head.load(std::memory_order_relaxed);
+    if (head == tail.load(std::memory_order_acquire)) return false;
+    item = std::move(items[head & (Size - 1)]); //moved out: the slot does not keep a copy (e.g. of a shared_ptr)
+    this->head.store(head + 1, std::memory_order_release); //the slot is read before the producer can reuse it
+    return true;
+  }
+
+  //approximate if called by another task than the consumer
+  size_t depth() const {return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);}
+
+  static constexpr size_t capacity() {return Size;}
+
+private:
+  T items[Size];
+  std::atomic<size_t> head{0}; //next to pop
+  std::atomic<size_t> tail{0}; //next to push
+};
@@ -54,15 +54,66 @@
 
 #include <vector>
 
+//cpu cycles for timing module callbacks, 32 bits so differences are valid up to 17 seconds at 240MHz
+inline unsigned32 perfCycles() {
+  #ifdef ESP_PLATFORM
+    return ESP.getCycleCount();
+  #else
+    return micros() * 1000; //host: 1000 'cycles' per microsecond
+  #endif
+}
+
+enum ModuleCalls {
+  call_loop,
+  call_loop20ms,
+  call_loop1s,
+  call_loop10s,
+  call_count // keep as last entry
+};
+
+#define CALL_BUCKETS 8 //histogram of call times in microseconds: <10, <30, <100, <300, <1000, <3000, <10000, 10000 or more
+
+//min, avg and max of a module callback, only compares and additions when a call is added
+struct CallStats {
+  static unsigned32 cyclesPerMicro; //set by SysModules::setup from the cpu frequency
+
+  unsigned32 count = 0;
+  unsigned32 minCycles = UINT32_MAX;
+  unsigned32 maxCycles = 0;
+  uint64_t sumCycles = 0;
+  unsigned16 histogram[CALL_BUCKETS] = {0};
+
+  void add(unsigned32 cycles) {
+    count++;
+    if (cycles < minCycles) minCycles = cycles;
+    if (cycles > maxCycles) maxCycles = cycles;
+    sumCycles += cycles;
+    static constexpr unsigned16 bounds[CALL_BUCKETS - 1] = {10, 30, 100, 300, 1000, 3000, 10000};
+    unsigned32 micros = cycles / cyclesPerMicro;
+    stackUnsigned8 bucket = 0;
+    while (bucket < CALL_BUCKETS - 1 && micros >= bounds[bucket]) bucket++;
+    if (histogram[bucket] < UINT16_MAX) histogram[bucket]++;
+  }
+
+  unsigned32 minMicros() {return count?minCycles / cyclesPerMicro:0;}
+  unsigned32 avgMicros() {return count?sumCycles / count / cyclesPerMicro:0;}
+  unsigned32 maxMicros() {return maxCycles / cyclesPerMicro;}
+
+  void clear() {*this = CallStats();}
+};
+
 class SysModule {
 
 public:
   const char * name;
   bool success;
   bool isEnabled;
-  unsigned long twentyMsMillis = millis() - random(1000); //random so not all 1s are fired at once
-  unsigned long oneSecondMillis = millis() - random(1000); //random so not all 1s are fired at once
-  unsigned long tenSecondMillis = millis() - random(10000); //random within a second
+  bool deferSetup = false; //setup after the first output, see SysModules::add
+  bool isSetup = false;
+  unsigned32 setupMicros = 0;
+  unsigned32 lateCount = 0; //scheduled tasks of this module which missed a full period (see SysModules::loop)
+  CallStats perf[call_count]; //time spent in loop, loop20ms, loop1s and loop10s since boot or reset
+  uint64_t perfWindowCycles = 0; //all calls in the last second
 
   JsonObject parentVar;
 
@@ -86,7 +137,7 @@ public:
   virtual void onOffChanged() {}
 
   virtual void testManager() {}
-  virtual void performanceManager() {}
+  virtual void performanceManager() {} //called every second after perf is shown in the UI, e.g. for module specific accounting
   virtual void dataSizeManager() {}
   virtual void codeSizeManager() {}
 };
\ No newline at end of file
@@ -14,20 +14,45 @@
 #include "Sys/SysModUI.h"
 #include "Sys/SysModWeb.h"
 #include "Sys/SysModModel.h"
+#include <algorithm>
+
+unsigned32 CallStats::cyclesPerMicro = 240;
+
+//heap order: the earliest deadline on top, wrap safe (millis() wraps after 49 days)
+static bool laterDeadline(const ScheduledTask &a, const ScheduledTask &b) {
+  return (long)(a.deadline - b.deadline) > 0;
+}
 
 SysModules::SysModules() {
 };
 
 void SysModules::setup() {
+  #ifdef ESP_PLATFORM
+    CallStats::cyclesPerMicro = ESP.getCpuFreqMHz();
+  #else
+    CallStats::cyclesPerMicro = 1000;
+  #endif
+
+  //deferred modules are set up in loop()
   for (SysModule *module:modules) {
-    module->setup();
+    if (!module->deferSetup) setupModule(module);
+  }
+
+  //spread the 20ms, 1s and 10s loops of the modules over their period, so not all 1s (and 10s) work is done in the same loop
+  for (forUnsigned8 index = 0; index < modules.size(); index++) {
+    SysModule *module = modules[index];
+    schedule(module, 20, index * 20 / modules.size(), [this, module]() {timedCall(module, call_loop20ms);});
+    schedule(module, 1000, index * 1000 / modules.size(), [this, module]() {timedCall(module, call_loop1s);});
+    schedule(module, 10000, index * 10000 / modules.size(), [this, module]() {timedCall(module, call_loop10s);});
   }
 
-  //delete mdlTbl values if nr of modules has changed (new values created using module defaults)
-  for (JsonObject childVar: mdl->varChildren("mdlTbl")) {
-    if (!childVar["value"].isNull() && mdl->varValArray(childVar).size() != modules.size()) {
-      ppf("mdlTbl clear (%s %s) %d %d\n", childVar["id"].as<String>().c_str(), childVar["value"].as<String>().c_str(), modules.size(), mdl->varValArray(childVar).size());
-      childVar.remove("value");
+  //delete mdlTbl and perfTbl values if nr of modules has changed (new values created using module defaults)
+  for (const char *tableId: {"mdlTbl", "perfTbl"}) {
+    for (JsonObject childVar: mdl->varChildren(tableId)) {
+      if (!childVar["value"].isNull() && mdl->varValArray(childVar).size() != modules.size()) {
+        ppf("%s clear (%s %s) %d %d\n", tableId, childVar["id"].as<String>().c_str(), childVar["value"].as<String>().c_str(), modules.size(), mdl->varValArray(childVar).size());
+        childVar.remove("value");
+      }
     }
   }
 
@@ -79,7 +104,7 @@ void SysModules::setup() {
     case onChange:
       if (rowNr != UINT8_MAX && rowNr < modules.size()) {
         modules[rowNr]->isEnabled = mdl->getValue(var, rowNr);
-        modules[rowNr]->enabledChanged();
+        if (modules[rowNr]->isSetup) modules[rowNr]->enabledChanged(); //deferred modules: see setupModule
       }
       else {
         ppf(" no rowNr or %d > modules.size %d!!\n", rowNr, modules.size());
@@ -88,36 +113,136 @@ void SysModules::setup() {
       return true;
     default: return false;
   }});
+
+  ui->initNumber(tableVar, "mdlLate", UINT16_MAX, 0, UINT16_MAX, true, [this](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+    case onSetValue:
+      for (forUnsigned8 rowNr = 0; rowNr < modules.size(); rowNr++)
+        mdl->setValue(var, modules[rowNr]->lateCount, rowNr);
+      return true;
+    case onUI:
+      ui->setLabel(var, "Late");
+      ui->setComment(var, "Scheduled tasks which missed a full period");
+      return true;
+    default: return false;
+  }});
+
+  ui->initNumber(tableVar, "mdlSetup", UINT16_MAX, 0, UINT16_MAX, true, [this](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+    case onSetValue:
+      for (forUnsigned8 rowNr = 0; rowNr < modules.size(); rowNr++)
+        mdl->setValue(var, modules[rowNr]->setupMicros / 1000, rowNr);
+      return true;
+    case onUI:
+      ui->setLabel(var, "Setup");
+      ui->setComment(var, "ms");
+      return true;
+    default: return false;
+  }});
+
+  ui->initText(parentVar, "bootPhases", nullptr, 128, true, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+    case onUI:
+      ui->setLabel(var, "Boot");
+      ui->setComment(var, "phase: duration @ ms since boot");
+      return true;
+    default: return false;
+  }});
+
+  tableVar = ui->initTable(parentVar, "perfTbl", nullptr, true, [](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+    case onUI:
+      ui->setLabel(var, "Performance");
+      ui->setComment(var, "Time spent per module in µs, click a header to sort, details in /json/perf");
+      return true;
+    default: return false;
+  }});
+
+  ui->initText(tableVar, "perfName", nullptr, 32, true, [this](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+    case onSetValue:
+      for (forUnsigned8 rowNr = 0; rowNr < modules.size(); rowNr++)
+        mdl->setValue(var, JsonString(modules[rowNr]->name, JsonString::Copied), rowNr);
+      return true;
+    case onUI:
+      ui->setLabel(var, "Name");
+      return true;
+    default: return false;
+  }});
+
+  //read only number columns, values are sent every second (not stored in the model)
+  const char *perfColumns[] = {"perfCpu", "perfLoopAvg", "perfLoopMax", "perf20msMax", "perf1sMax", "perf10sMax"};
+  const char *perfLabels[] = {"CPU ‰", "Loop avg", "Loop max", "20ms max", "1s max", "10s max"};
+  for (forUnsigned8 column = 0; column < sizeof(perfColumns) / sizeof(perfColumns[0]); column++) {
+    const char *label = perfLabels[column];
+    ui->initNumber(tableVar, perfColumns[column], UINT16_MAX, 0, UINT16_MAX, true, [this, label](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+      case onSetValue:
+        for (forUnsigned8 rowNr = 0; rowNr < modules.size(); rowNr++)
+          mdl->setValue(var, 0, rowNr);
+        return true;
+      case onUI:
+        ui->setLabel(var, label);
+        return true;
+      default: return false;
+    }});
+  }
+
+  ui->initButton(parentVar, "perfReset", false, [this](JsonObject var, unsigned8 rowNr, unsigned8 funType) { switch (funType) { //varFun
+    case onUI:
+      ui->setComment(var, "Clear min, avg, max and histograms");
+      return true;
+    case onChange:
+      for (SysModule *module:modules)
+        for (CallStats &stats: module->perf) stats.clear();
+      return true;
+    default: return false;
+  }});
+
+  //update late counts and performance in the UI (not in the model), then let modules do their own accounting
+  schedule(nullptr, 1000, 500, [this]() {
+    unsigned long now = millis();
+    unsigned32 elapsedMillis = max(now - perfMillis, 1UL);
+    perfMillis = now;
+    for (forUnsigned8 rowNr = 0; rowNr < modules.size(); rowNr++) {
+      SysModule *module = modules[rowNr];
+      web->addResponse("mdlLate", "value", module->lateCount, rowNr);
+      web->addResponse("mdlSetup", "value", module->setupMicros / 1000, rowNr);
+      web->addResponse("perfCpu", "value", (unsigned32)(module->perfWindowCycles / CallStats::cyclesPerMicro / elapsedMillis), rowNr); //µs per ms = ‰
+      web->addResponse("perfLoopAvg", "value", module->perf[call_loop].avgMicros(), rowNr);
+      web->addResponse("perfLoopMax", "value", module->perf[call_loop].maxMicros(), rowNr);
+      web->addResponse("perf20msMax", "value", module->perf[call_loop20ms].maxMicros(), rowNr);
+      web->addResponse("perf1sMax", "value", module->perf[call_loop1s].maxMicros(), rowNr);
+      web->addResponse("perf10sMax", "value", module->perf[call_loop10s].maxMicros(), rowNr);
+      module->perfWindowCycles = 0;
+      if (module->isEnabled && module->success && module->isSetup) module->performanceManager();
+    }
+
+    if (bootPhasesChanged) {
+      bootPhasesChanged = false;
+      char text[128] = "";
+      for (BootPhase &phase: bootPhases) {
+        size_t length = strlen(text);
+        snprintf(text + length, sizeof(text) - length, "%s%s: %u @ %lu", length?", ":"", phase.name, phase.durationMicros / 1000, phase.atMillis);
+      }
+      mdl->setUIValueV("bootPhases", "%s", text);
+    }
+  });
 }
 
 void SysModules::loop() {
-  // bool oneSec = false;
-  // bool tenSec = false;
-  // if (millis() - oneSecondMillis >= 1000) {
-  //   oneSecondMillis = millis();
-  //   oneSec = true;
-  // }
-  // if (millis() - tenSecondMillis >= 10000) {
-  //   tenSecondMillis = millis();
-  //   tenSec = true;
-  // }
+  //staged startup: one deferred module per loop, after the first output, so the output keeps running in between
+  if (!allSetup && (outputStarted || millis() > 2000)) {
+    SysModule *next = nullptr;
+    for (SysModule *module:modules) {
+      if (!module->isSetup) {next = module; break;}
+    }
+    if (next)
+      setupModule(next);
+    else {
+      allSetup = true;
+      bootPhase("all setup", 0);
+    }
+  }
+
   for (SysModule *module:modules) {
-    if (module->isEnabled && module->success) {
-      module->loop();
-      if (millis() - module->twentyMsMillis >= 20) {
-        module->twentyMsMillis = millis();
-        module->loop20ms();
-      }
-      if (millis() - module->oneSecondMillis >= 1000) {
-        module->oneSecondMillis = millis();
-        module->loop1s();
-      }
-      if (millis() - module->tenSecondMillis >= 10000) {
-        module->tenSecondMillis = millis();
-        module->loop10s();
-      }
+    if (module->isEnabled && module->success && module->isSetup) {
+      timedCall(module, call_loop);
       // module->testManager();
-      // module->performanceManager();
       // module->dataSizeManager();
       // module->codeSizeManager();
     }
@@ -128,6 +253,75 @@ void SysModules::loop() {
     connectedChanged();
   }
 
+  //run the due tasks only: one millis() per loop, the heap top tells if anything is due
+  unsigned long now = millis();
+  while (!tasks.empty() && (long)(now - tasks.front().deadline) >= 0) {
+    std::pop_heap(tasks.begin(), tasks.end(), laterDeadline);
+    ScheduledTask task = std::move(tasks.back());
+    tasks.pop_back();
+
+    if (now - task.deadline >= (task.period?task.period:SCHEDULE_LATE_ONESHOT_MS)) { //late: a full period missed (skipped below), jitter within the period is not counted
+      lateTasks++;
+      if (task.module) task.module->lateCount++;
+    }
+
+    if (task.module == nullptr || (task.module->isEnabled && task.module->success && task.module->isSetup))
+      task.fun();
+
+    if (task.period) {
+      //next deadline on the grid after now: missed periods are skipped (no catching up) and the phase is kept
+      task.deadline += task.period * ((now - task.deadline) / task.period + 1);
+      pushTask(std::move(task));
+    }
+  }
+}
+
+void SysModules::timedCall(SysModule *module, unsigned8 call) {
+  unsigned32 startCycles = perfCycles();
+  switch (call) {
+    case call_loop: module->loop(); break;
+    case call_loop20ms: module->loop20ms(); break;
+    case call_loop1s: module->loop1s(); break;
+    case call_loop10s: module->loop10s(); break;
+  }
+  unsigned32 cycles = perfCycles() - startCycles;
+  module->perf[call].add(cycles);
+  module->perfWindowCycles += cycles;
+}
+
+void SysModules::perfToJson(JsonObject root) {
+  const char *callNames[call_count] = {"loop", "loop20ms", "loop1s", "loop10s"};
+  root["cyclesPerMicro"] = CallStats::cyclesPerMicro;
+  root["lateTasks"] = lateTasks;
+  JsonArray modulesArray = root["modules"].to<JsonArray>();
+  for (SysModule *module:modules) {
+    JsonObject moduleObject = modulesArray.add<JsonObject>();
+    moduleObject["name"] = module->name;
+    moduleObject["late"] = module->lateCount;
+    for (forUnsigned8 call = 0; call < call_count; call++) {
+      CallStats &stats = module->perf[call];
+      JsonObject callObject = moduleObject[callNames[call]].to<JsonObject>();
+      callObject["count"] = stats.count;
+      callObject["min"] = stats.minMicros();
+      callObject["avg"] = stats.avgMicros();
+      callObject["max"] = stats.maxMicros();
+      JsonArray histogram = callObject["histogram"].to<JsonArray>();
+      for (unsigned16 bucketCount: stats.histogram) histogram.add(bucketCount);
+    }
+  }
+}
+
+void SysModules::schedule(SysModule *module, unsigned32 period, unsigned32 phase, TaskFun fun) {
+  pushTask({millis() + phase, period, module, fun});
+}
+
+void SysModules::scheduleOnce(unsigned32 delay, TaskFun fun, SysModule *module) {
+  pushTask({millis() + delay, 0, module, fun});
+}
+
+void SysModules::pushTask(ScheduledTask &&task) {
+  tasks.push_back(std::move(task));
+  std::push_heap(tasks.begin(), tasks.end(), laterDeadline);
 }
 
 void SysModules::reboot() {
@@ -136,12 +330,29 @@ void SysModules::reboot() {
   }
 }
 
-void SysModules::add(SysModule* module) {
+void SysModules::add(SysModule* module, bool deferSetup) {
+  module->deferSetup = deferSetup;
   modules.push_back(module);
 }
 
+void SysModules::setupModule(SysModule *module) {
+  unsigned long startMicros = micros();
+  module->setup();
+  module->setupMicros = micros() - startMicros;
+  module->isSetup = true;
+  ppf("setup %s %u µs%s\n", module->name, module->setupMicros, module->deferSetup?" (deferred)":"");
+  //a deferred module missed connectedChanged / enabledChanged while not set up (connectedChanged calls onOffChanged by default)
+  if (module->deferSetup && isConnected) module->connectedChanged();
+}
+
+void SysModules::bootPhase(const char *name, unsigned32 durationMicros) {
+  bootPhases.push_back({name, durationMicros, millis()});
+  bootPhasesChanged = true;
+  ppf("boot %s %u µs @ %lu ms\n", name, durationMicros, millis());
+}
+
 void SysModules::connectedChanged() {
   for (SysModule *module:modules) {
-    module->connectedChanged();
+    if (module->isSetup) module->connectedChanged(); //not set up yet: called by setupModule
   }
 }
\ No newline at end of file
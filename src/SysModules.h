@@ -11,6 +11,18 @@
 
 #pragma once
 #include "SysModule.h"
+#include <functional>
+
+#define SCHEDULE_LATE_ONESHOT_MS 20 //a one-shot task is late if it runs this much after its deadline (a loop20ms period)
+
+typedef std::function<void()> TaskFun;
+
+struct ScheduledTask {
+  unsigned long deadline; //millis
+  unsigned32 period; //0: one-shot
+  SysModule *module; //nullptr: always run, else only if the module is enabled and successful
+  TaskFun fun;
+};
 
 class SysModules {
 public:
@@ -25,14 +37,48 @@ public:
 
   void reboot();
 
-  void add(SysModule* module);
+  //deferSetup: setup after outputStarted (network and web modules), so the app's output (e.g. leds) comes first
+  void add(SysModule* module, bool deferSetup = false);
 
   void connectedChanged();
 
+  //run fun every period ms, first after phase ms. Tasks with the same period should get different phases so they do not run in the same loop
+  void schedule(SysModule *module, unsigned32 period, unsigned32 phase, TaskFun fun);
+
+  //run fun once after delay ms
+  void scheduleOnce(unsigned32 delay, TaskFun fun, SysModule *module = nullptr);
+
+  unsigned32 lateTasks = 0; //all modules
+
+  bool outputStarted = false; //set by the app after its first output (e.g. the first frame shown), deferred setups start then (or after 2s)
+  bool allSetup = false; //all modules, including the deferred ones
+
+  //boot profiler: duration of a boot phase, shown in bootPhases (module setups are shown in mdlSetup)
+  void bootPhase(const char *name, unsigned32 durationMicros);
+
+  //min, avg, max (µs) and histogram of each module callback, served on /json/perf
+  void perfToJson(JsonObject root);
+
 private:
   std::vector<SysModule *> modules;
-  // unsigned long oneSecondMillis = 0;
-  // unsigned long tenSecondMillis = millis() - 4500;
+  std::vector<ScheduledTask> tasks; //min-heap on deadline: tasks.front() is the first due
+
+  unsigned long perfMillis = 0; //last time perfCpu was shown
+
+  struct BootPhase {
+    const char *name;
+    unsigned32 durationMicros;
+    unsigned long atMillis; //since boot, at the end of the phase
+  };
+  std::vector<BootPhase> bootPhases;
+  bool bootPhasesChanged = false;
+
+  void setupModule(SysModule *module);
+
+  void pushTask(ScheduledTask &&task);
+
+  //calls loop, loop20ms, loop1s or loop10s and adds the time spent to module->perf
+  void timedCall(SysModule *module, unsigned8 call);
 };
 
 extern SysModules *mdls;
\ No newline at end of file
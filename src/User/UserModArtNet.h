@@ -71,7 +71,9 @@ public:
 
     if(!targetIp) return;
 
-    if(!eff->newFrame) return;
+    if(!eff->newFrame || !eff->networkFrame()) return;
+
+    FrameGovernor::NetworkTimer timer{eff->governor}; //send time counts in the frame budget
 
     // calculate the number of UDP packets we need to send
     bool isRGBW = false;
@@ -116,7 +118,7 @@ public:
       ddpUdp.write(0xFF & (packetSize     )); // 16-bit length of channel data, LSB
 
       for (size_t i = 0; i < eff->fixture.nrOfLeds; i++) {
-        CRGB pixel = eff->fixture.ledsP[i];
+        CRGB pixel = eff->fixture.presentedP()[i];
         ddpUdp.write(scale8(pixel.r, fix->bri)); // R
         ddpUdp.write(scale8(pixel.g, fix->bri)); // G
         ddpUdp.write(scale8(pixel.b, fix->bri)); // B
@@ -88,7 +88,9 @@ public:
 
     if(!targetIp) return;
 
-    if(!eff->newFrame) return;
+    if(!eff->newFrame || !eff->networkFrame()) return;
+
+    FrameGovernor::NetworkTimer timer{eff->governor}; //send time counts in the frame budget
 
     // calculate the number of UDP packets we need to send
     bool isRGBW = false;
@@ -140,7 +142,7 @@ public:
       /*9*/ddpUdp.write(0xFF & (packetSize     ));
 
       for (size_t i = 0; i < eff->fixture.nrOfLeds; i++) {
-        CRGB pixel = eff->fixture.ledsP[i];
+        CRGB pixel = eff->fixture.presentedP()[i];
         ddpUdp.write(scale8(pixel.r, fix->bri)); // R
         ddpUdp.write(scale8(pixel.g, fix->bri)); // G
         ddpUdp.write(scale8(pixel.b, fix->bri)); // B
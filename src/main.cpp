@@ -113,6 +113,7 @@ void setup() {
   //Reorder with care! this is the order in which setup and loop is executed
   //If changed make sure mdlEnabled.onChange executes var["value"].to<JsonArray>(); and saveModel! 
   //Default: add below, not in between
+  //add(module, true): network and web modules are set up after the first output (staged startup)
   #ifdef STARLIGHT
     mdls->add(fix);
     mdls->add(eff);
@@ -122,8 +123,8 @@ void setup() {
   mdls->add(sys);
   mdls->add(pinsM);
   mdls->add(print);
-  mdls->add(web);
-  mdls->add(net);
+  mdls->add(web, true);
+  mdls->add(net, true);
   #ifdef STARLIGHT
     #ifdef STARLIGHT_USERMOD_DDP
       mdls->add(ddpmod);
@@ -133,10 +134,10 @@ void setup() {
     #endif
   #endif
   #ifdef STARBASE_USERMOD_E131
-    mdls->add(e131mod);
+    mdls->add(e131mod, true);
   #endif
   #ifdef STARBASE_USERMOD_HA
-    mdls->add(hamod); //no ui
+    mdls->add(hamod, true); //no ui
   #endif
   #ifdef STARBASE_USERMOD_MPU6050
     mdls->add(mpu6050);
@@ -146,8 +147,8 @@ void setup() {
   #ifdef STARLIGHT_USERMOD_WLEDAUDIO
     mdls->add(wledAudioMod); //no ui
   #endif
-  mdls->add(mdns); //no ui
-  mdls->add(instances);
+  mdls->add(mdns, true); //no ui
+  mdls->add(instances, true);
   #ifdef STARBASE_USERMOD_LIVE
     mdls->add(liveM);
   #endif
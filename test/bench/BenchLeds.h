@@ -0,0 +1,150 @@
+/*
+   @title     StarLight
+   @file      BenchLeds.h
+   @date      20240720
+   @repo      https://github.com/MoonModules/StarLight
+   @Authors   https://github.com/MoonModules/StarLight/commits/main
+   @Copyright © 2024 Github StarLight Commit Authors
+   @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+   @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+*/
+
+// Host stand-in for Leds, used by the benchmarks and checks in this directory (see README)
+//   the src tree needs the ESP32 Arduino core, FastLED and ArduinoJson, so the code under test is mirrored in the .cpp files here
+//   keep the mirrored functions in sync with src/App when changing them
+//   FastLED math is copied from lib8tion (FASTLED_SCALE8_FIXED and FASTLED_BLEND_FIXED, the defaults), so results are bit exact
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+typedef uint8_t unsigned8;
+typedef uint16_t unsigned16;
+typedef uint32_t unsigned32;
+typedef uint8_t byte; //Arduino
+
+static inline uint8_t scale8(uint8_t i, uint8_t scale) {return ((uint16_t)i * (1 + (uint16_t)scale)) >> 8;}
+
+static inline uint8_t blend8(uint8_t a, uint8_t b, uint8_t amountOfB) {
+  uint16_t partial = (a << 8) | b;
+  partial += (b * amountOfB);
+  partial -= (a * amountOfB);
+  return partial >> 8;
+}
+
+struct CRGB {
+  uint8_t r, g, b;
+  CRGB &nscale8(uint8_t scale) {r = scale8(r, scale); g = scale8(g, scale); b = scale8(b, scale); return *this;}
+  bool operator==(const CRGB &other) const {return r == other.r && g == other.g && b == other.b;}
+};
+
+//FastLED blend(p1, p2, amountOfP2)
+static inline CRGB blend(const CRGB &p1, const CRGB &p2, uint8_t amountOfP2) {
+  return {blend8(p1.r, p2.r, amountOfP2), blend8(p1.g, p2.g, amountOfP2), blend8(p1.b, p2.b, amountOfP2)};
+}
+
+//FastLED fadeToBlackBy(leds, n, fadeBy)
+static inline void fastled_fadeToBlackBy(CRGB *leds, unsigned16 num_leds, unsigned8 fadeBy) {
+  for (unsigned16 i = 0; i < num_leds; i++) leds[i].nscale8(255 - fadeBy);
+}
+
+struct Coord3D {
+  int x, y, z;
+};
+
+enum MapTypes {m_color, m_onePixel, m_morePixels};
+
+struct PhysMap {
+  unsigned8 mapType = m_color;
+  unsigned16 indexP = 0;
+  std::vector<unsigned16> *indexes = nullptr;
+  unsigned8 getMapType() const {return mapType;}
+};
+
+struct Leds;
+
+struct Projection {
+  void adjustXYZ(Leds &leds, Coord3D &pixel) {}
+};
+
+//mapping table lookup, projection call through a cached member pointer and globalBlend, as in Leds
+struct Leds {
+  Coord3D size;
+  std::vector<PhysMap> mappingTable;
+  std::vector<std::vector<unsigned16>> moreIndexes;
+  std::vector<CRGB> ledsP;
+  unsigned16 nrOfLeds;
+  unsigned8 globalBlend = 0;
+  Projection projection;
+  void (Projection::*adjustXYZCached)(Leds &, Coord3D &) = &Projection::adjustXYZ;
+
+  //every virtual pixel mapped to one physical pixel, in reverse order so the mapping is not the identity
+  Leds(int x, int y, int z): size{x, y, z} {
+    nrOfLeds = x * y * z;
+    mappingTable.resize(nrOfLeds);
+    ledsP.resize(nrOfLeds);
+    for (unsigned16 i = 0; i < nrOfLeds; i++) {
+      mappingTable[i].mapType = m_onePixel;
+      mappingTable[i].indexP = nrOfLeds - 1 - i;
+    }
+  }
+
+  unsigned16 XYZUnprojected(Coord3D pixel) {
+    if (pixel.x >= 0 && pixel.y >= 0 && pixel.z >= 0 && pixel.x < size.x && pixel.y < size.y && pixel.z < size.z)
+      return pixel.x + pixel.y * size.x + pixel.z * size.x * size.y;
+    return UINT16_MAX;
+  }
+
+  __attribute__((noinline)) unsigned16 XYZ(Coord3D pixel) {
+    (projection.*adjustXYZCached)(*this, pixel);
+    return XYZUnprojected(pixel);
+  }
+
+  __attribute__((noinline)) void setPixelColor(unsigned16 indexV, CRGB color, unsigned8 blendAmount = UINT8_MAX) {
+    if (indexV < mappingTable.size()) {
+      switch (mappingTable[indexV].getMapType()) {
+        case m_onePixel: {
+          unsigned16 indexP = mappingTable[indexV].indexP;
+          ledsP[indexP] = blend(color, ledsP[indexP], blendAmount == UINT8_MAX?globalBlend:blendAmount);
+          break; }
+        case m_morePixels:
+          for (unsigned16 indexP: *mappingTable[indexV].indexes)
+            ledsP[indexP] = blend(color, ledsP[indexP], blendAmount == UINT8_MAX?globalBlend:blendAmount);
+          break;
+      }
+    }
+  }
+  void setPixelColor(Coord3D pixel, CRGB color, unsigned8 blendAmount = UINT8_MAX) {setPixelColor(XYZ(pixel), color, blendAmount);}
+
+  CRGB getPixelColor(unsigned16 indexV) {
+    if (indexV < mappingTable.size()) {
+      switch (mappingTable[indexV].getMapType()) {
+        case m_onePixel: return ledsP[mappingTable[indexV].indexP];
+        case m_morePixels: return ledsP[*mappingTable[indexV].indexes->begin()];
+      }
+    }
+    return {0, 0, 0};
+  }
+
+  bool isMapped(unsigned16 indexV) {return indexV < mappingTable.size() && mappingTable[indexV].getMapType() != m_color;}
+
+  void fill_solid(CRGB color) {
+    for (unsigned16 i = 0; i < mappingTable.size(); i++) setPixelColor(i, color, 0);
+  }
+};
+
+static double benchSeconds() {return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();}
+
+//calls f(i) n times, returns calls per second
+template<class F> double benchRate(F f, int n) {
+  double start = benchSeconds();
+  for (int i = 0; i < n; i++) f(i);
+  return n / (benchSeconds() - start);
+}
@@ -0,0 +1,210 @@
+/*
+   @title     StarLight
+   @file      fadeCheck.cpp
+   @date      20240720
+   @repo      https://github.com/MoonModules/StarLight
+   @Authors   https://github.com/MoonModules/StarLight/commits/main
+   @Copyright © 2024 Github StarLight Commit Authors
+   @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+   @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+*/
+
+// Deferred fadeToBlackBy (Leds::applyFade) against separate fadeToBlackBy passes, byte for byte, and the time of both
+//   mirrors Leds::fadeToBlackBy, applyFade, fadePixel and the fill_solid shortcut in src/App/LedLeds.h/.cpp
+//   on the device, build with -D STARLIGHT_FADE_CHECK to run the same comparison on the real code
+
+#include "BenchLeds.h"
+
+//fadeToBlackBy as it was before user-029: one pass per call
+struct EagerLeds: Leds {
+  bool fastPath = false;
+  using Leds::Leds;
+
+  void fadeToBlackBy(unsigned8 fadeBy) {
+    if (fastPath) {
+      fastled_fadeToBlackBy(ledsP.data(), nrOfLeds, fadeBy);
+    } else {
+      for (PhysMap &map:mappingTable) {
+        switch (map.getMapType()) {
+          case m_onePixel: {
+            unsigned16 indexP = map.indexP;
+            CRGB oldValue = ledsP[indexP];
+            ledsP[indexP].nscale8(255-fadeBy);
+            ledsP[indexP] = blend(ledsP[indexP], oldValue, globalBlend);
+            break; }
+          case m_morePixels:
+            for (unsigned16 indexP:*map.indexes) {
+              CRGB oldValue = ledsP[indexP];
+              ledsP[indexP].nscale8(255-fadeBy);
+              ledsP[indexP] = blend(ledsP[indexP], oldValue, globalBlend);
+            }
+            break;
+        }
+      }
+    }
+  }
+  void setPixelColor(unsigned16 indexV, CRGB color) {Leds::setPixelColor(indexV, color);}
+  void fill_solid(CRGB color) {
+    if (fastPath) std::fill(ledsP.begin(), ledsP.end(), color);
+    else for (unsigned16 i = 0; i < mappingTable.size(); i++) Leds::setPixelColor(i, color, 0);
+  }
+};
+
+//fadeToBlackBy as it is now: collected, applied in one pass before the next read or write and after the effect loop
+struct DeferredLeds: Leds {
+  bool fastPath = false;
+  unsigned8 fadePending[4];
+  unsigned8 nrOfFadesPending = 0;
+  using Leds::Leds;
+
+  void fadeToBlackBy(unsigned8 fadeBy) {
+    if (nrOfFadesPending == sizeof(fadePending)) applyFade();
+    fadePending[nrOfFadesPending++] = fadeBy;
+  }
+
+  void applyFade() {
+    unsigned8 nrOfFades = nrOfFadesPending;
+    nrOfFadesPending = 0;
+    if (nrOfFades == 0) return;
+
+    if (fastPath) {
+      for (unsigned8 i = 0; i < nrOfFades; i++) //no mapping table to walk: fastled's pass per fade is as fast as one pass doing all
+        fastled_fadeToBlackBy(ledsP.data(), nrOfLeds, fadePending[i]);
+    } else {
+      for (PhysMap &map:mappingTable) {
+        switch (map.getMapType()) {
+          case m_onePixel:
+            fadePixel(map.indexP, nrOfFades);
+            break;
+          case m_morePixels:
+            for (unsigned16 indexP:*map.indexes)
+              fadePixel(indexP, nrOfFades);
+            break;
+        }
+      }
+    }
+  }
+
+  void fadePixel(unsigned16 indexP, unsigned8 nrOfFades) {
+    CRGB color = ledsP[indexP];
+    if (!(color.r | color.g | color.b)) return; //black stays black (most pixels of trail effects)
+    for (unsigned8 i = 0; i < nrOfFades; i++) {
+      CRGB oldValue = color;
+      color.nscale8(255-fadePending[i]);
+      if (globalBlend) color = blend(color, oldValue, globalBlend);
+    }
+    ledsP[indexP] = color;
+  }
+
+  void setPixelColor(unsigned16 indexV, CRGB color) {
+    if (nrOfFadesPending) applyFade();
+    Leds::setPixelColor(indexV, color);
+  }
+  void fill_solid(CRGB color) { //noBlend
+    nrOfFadesPending = 0;
+    if (fastPath) std::fill(ledsP.begin(), ledsP.end(), color);
+    else for (unsigned16 i = 0; i < mappingTable.size(); i++) Leds::setPixelColor(i, color, 0);
+  }
+};
+
+//layer with unmapped pixels and pixels mapped to more than one physical pixel, as projectAndMap makes them:
+//  each physical pixel is mapped to one virtual pixel (the deferred pass relies on that)
+template<class L> void makeLayer(L &leds, bool fastPath) {
+  leds.fastPath = fastPath;
+  if (fastPath) return;
+  leds.moreIndexes.assign(leds.nrOfLeds, {});
+  for (unsigned16 indexP = 0; indexP < leds.nrOfLeds; indexP++)
+    leds.moreIndexes[(indexP * 7 / 10 * 13) % leds.nrOfLeds].push_back(indexP); //some virtual pixels get 0, 1 or 2 physical pixels
+  for (unsigned16 indexV = 0; indexV < leds.nrOfLeds; indexV++) {
+    PhysMap &map = leds.mappingTable[indexV];
+    switch (leds.moreIndexes[indexV].size()) {
+      case 0: map.mapType = m_color; break;
+      case 1: map.mapType = m_onePixel; map.indexP = leds.moreIndexes[indexV][0]; break;
+      default: map.mapType = m_morePixels; map.indexes = &leds.moreIndexes[indexV]; break;
+    }
+  }
+}
+
+static uint32_t rngState = 1;
+static uint32_t nextRandom() {rngState = rngState * 1664525 + 1013904223; return rngState >> 8;}
+
+int main() {
+  unsigned32 frames = 0, differences = 0;
+  for (int fastPath = 0; fastPath < 2; fastPath++) {
+    EagerLeds eager(16, 16, 1);
+    DeferredLeds deferred(16, 16, 1);
+    makeLayer(eager, fastPath);
+    makeLayer(deferred, fastPath);
+    for (auto &color: eager.ledsP) color = {(uint8_t)nextRandom(), (uint8_t)nextRandom(), (uint8_t)nextRandom()};
+    deferred.ledsP = eager.ledsP;
+
+    for (int frame = 0; frame < 200000; frame++) {
+      unsigned8 globalBlend = (frame % 3 == 0)?0:nextRandom();
+      eager.globalBlend = deferred.globalBlend = globalBlend;
+      //a frame: some fades (more than fadePending holds), writes in between, sometimes a fill
+      unsigned8 steps = 1 + nextRandom() % 10;
+      for (unsigned8 step = 0; step < steps; step++) {
+        uint32_t r = nextRandom();
+        switch (r % 8) {
+          case 0: {
+            unsigned16 indexV = (r >> 3) % eager.nrOfLeds;
+            CRGB color = {(uint8_t)(r >> 5), (uint8_t)(r >> 11), (uint8_t)(r >> 17)};
+            eager.setPixelColor(indexV, color);
+            deferred.setPixelColor(indexV, color);
+            break; }
+          case 1:
+            if ((r >> 3) % 16 == 0) {
+              eager.fill_solid({(uint8_t)(r >> 7), 0, (uint8_t)(r >> 15)});
+              deferred.fill_solid({(uint8_t)(r >> 7), 0, (uint8_t)(r >> 15)});
+            }
+            break;
+          default: {
+            unsigned8 fadeBy = (r >> 3) % 4 == 0?255:(unsigned8)(r >> 5);
+            eager.fadeToBlackBy(fadeBy);
+            deferred.fadeToBlackBy(fadeBy);
+            break; }
+        }
+      }
+      deferred.applyFade(); //after the effect loop
+      frames++;
+      if (memcmp(eager.ledsP.data(), deferred.ledsP.data(), eager.nrOfLeds * sizeof(CRGB)) != 0) {
+        if (differences++ < 5) printf("difference in frame %d (fast path %d)\n", frame, fastPath);
+        deferred.ledsP = eager.ledsP;
+      }
+      //keep some light in the buffer
+      if (frame % 64 == 0) {
+        for (auto &color: eager.ledsP) color = {(uint8_t)nextRandom(), (uint8_t)nextRandom(), (uint8_t)nextRandom()};
+        deferred.ledsP = eager.ledsP;
+      }
+    }
+  }
+  printf("%u frames, %u with a difference between deferred and separate fades\n", frames, differences);
+
+  //time: an effect fading 3 times per frame on a 64x64 layer, mapped and not, with a buffer which stays lit (refilled every 16 frames) and one which fades to black
+  for (int fastPath = 0; fastPath < 2; fastPath++) {
+    for (int lit = 0; lit < 2; lit++) {
+      EagerLeds eager(64, 64, 1);
+      DeferredLeds deferred(64, 64, 1);
+      makeLayer(eager, fastPath);
+      makeLayer(deferred, fastPath);
+      eager.globalBlend = deferred.globalBlend = 128;
+      std::vector<CRGB> litFrame(eager.nrOfLeds);
+      for (auto &color: litFrame) color = {(uint8_t)(nextRandom() | 128), (uint8_t)(nextRandom() | 128), (uint8_t)(nextRandom() | 128)};
+      eager.ledsP = deferred.ledsP = litFrame;
+      int n = 20000;
+      double eagerRate = benchRate([&](int i) {
+        if (lit && i % 16 == 0) eager.ledsP = litFrame;
+        for (int k = 0; k < 3; k++) eager.fadeToBlackBy(20 + k);
+        eager.setPixelColor(i % 4096, {255, 255, 255});
+      }, n);
+      double deferredRate = benchRate([&](int i) {
+        if (lit && i % 16 == 0) deferred.ledsP = litFrame;
+        for (int k = 0; k < 3; k++) deferred.fadeToBlackBy(20 + k);
+        deferred.setPixelColor(i % 4096, {255, 255, 255});
+      }, n);
+      printf("64x64 %s, %s, 3 fades per frame: separate passes %.0f frames/s, deferred %.0f frames/s\n", fastPath?"no projection":"mapped", lit?"lit":"fading to black", eagerRate, deferredRate);
+    }
+  }
+
+  return differences != 0;
+}
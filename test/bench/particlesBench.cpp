@@ -0,0 +1,286 @@
+/*
+   @title     StarLight
+   @file      particlesBench.cpp
+   @date      20240720
+   @repo      https://github.com/MoonModules/StarLight
+   @Authors   https://github.com/MoonModules/StarLight/commits/main
+   @Copyright © 2024 Github StarLight Commit Authors
+   @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+   @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+*/
+
+// Particle engine (Particles in src/App/LedParticles.h) against the float particles probing the framebuffer it replaced, steps per second
+//   mirrors Particles::add, step and render, with std::vector instead of effectData and a fixed color instead of the palette
+//   checks the occupancy bitmap: one particle per cell, none on a barrier, occupied bits = particles + barriers
+
+#include "BenchLeds.h"
+
+#define NUM_VLEDS_Max 8192
+#define PARTICLE_SHIFT 8 //fixed point: 8 fractional bits
+#define PARTICLE_ONE (1 << PARTICLE_SHIFT) //one pixel in fixed point
+
+static uint32_t rngState = 1;
+static uint32_t nextRandom() {rngState = rngState * 1664525 + 1013904223; return rngState >> 8;}
+
+static CRGB colorFromIndex(unsigned8 index) {return {index, (uint8_t)(255 - index), 128};}
+
+struct Particles {
+  unsigned16 count = 0;
+  std::vector<int32_t> x, y, z;
+  std::vector<int16_t> vx, vy, vz;
+  std::vector<unsigned16> cell, prevCell;
+  std::vector<unsigned8> colorIndex;
+  std::vector<byte> occupied = std::vector<byte>((NUM_VLEDS_Max + 7) / 8);
+  std::vector<byte> barrier = std::vector<byte>((NUM_VLEDS_Max + 7) / 8);
+  int16_t gravity[3] = {0, 0, 0};
+
+  Particles(unsigned16 capacity): x(capacity), y(capacity), z(capacity), vx(capacity), vy(capacity), vz(capacity), cell(capacity), prevCell(capacity), colorIndex(capacity) {}
+
+  bool isOccupied(unsigned32 index) {return index >= NUM_VLEDS_Max || ((occupied[index >> 3] >> (index & 7)) & 1);}
+  bool isBarrier(unsigned32 index) {return (barrier[index >> 3] >> (index & 7)) & 1;}
+
+  void addBarrier(Leds &leds, Coord3D pos) {
+    unsigned32 index = cellIndex(leds, pos.x << PARTICLE_SHIFT, pos.y << PARTICLE_SHIFT, pos.z << PARTICLE_SHIFT);
+    if (index < NUM_VLEDS_Max) setBarrier(index);
+  }
+
+  bool add(Leds &leds, Coord3D pos, int16_t vx, int16_t vy, int16_t vz, unsigned8 colorIndex) {
+    if (count >= x.size()) return false;
+    unsigned32 index = cellIndex(leds, pos.x << PARTICLE_SHIFT, pos.y << PARTICLE_SHIFT, pos.z << PARTICLE_SHIFT);
+    if (isOccupied(index)) return false;
+    unsigned16 i = count++;
+    x[i] = pos.x << PARTICLE_SHIFT;
+    y[i] = pos.y << PARTICLE_SHIFT;
+    z[i] = pos.z << PARTICLE_SHIFT;
+    this->vx[i] = vx;
+    this->vy[i] = vy;
+    this->vz[i] = vz;
+    cell[i] = index;
+    prevCell[i] = UINT16_MAX;
+    this->colorIndex[i] = colorIndex;
+    setOccupied(index, true);
+    return true;
+  }
+
+  void step(Leds &leds) {
+    int32_t maxPos[3] = {(leds.size.x - 1) << PARTICLE_SHIFT, (leds.size.y - 1) << PARTICLE_SHIFT, (leds.size.z - 1) << PARTICLE_SHIFT};
+    for (unsigned16 i = 0; i < count; i++) {
+      vx[i] = std::min(std::max(vx[i] + gravity[0], -PARTICLE_ONE), PARTICLE_ONE);
+      vy[i] = std::min(std::max(vy[i] + gravity[1], -PARTICLE_ONE), PARTICLE_ONE);
+      vz[i] = std::min(std::max(vz[i] + gravity[2], -PARTICLE_ONE), PARTICLE_ONE);
+
+      int32_t nx = x[i] + vx[i];
+      int32_t ny = y[i] + vy[i];
+      int32_t nz = z[i] + vz[i];
+
+      //edges: stay inside and bounce with damping
+      if (nx < 0 || nx > maxPos[0]) {vx[i] = -vx[i] / 2; nx = x[i];}
+      if (ny < 0 || ny > maxPos[1]) {vy[i] = -vy[i] / 2; ny = y[i];}
+      if (nz < 0 || nz > maxPos[2]) {vz[i] = -vz[i] / 2; nz = z[i];}
+
+      unsigned32 newCell = cellIndex(leds, nx, ny, nz);
+      if (newCell != cell[i] && isOccupied(newCell)) {
+        //blocked: slide along the free axes, bounce on the blocked ones
+        int32_t tx = x[i], ty = y[i], tz = z[i];
+        if (nx != x[i]) {if (isFree(i, cellIndex(leds, nx, ty, tz))) tx = nx; else vx[i] = -vx[i] / 2;}
+        if (ny != y[i]) {if (isFree(i, cellIndex(leds, tx, ny, tz))) ty = ny; else vy[i] = -vy[i] / 2;}
+        if (nz != z[i]) {if (isFree(i, cellIndex(leds, tx, ty, nz))) tz = nz; else vz[i] = -vz[i] / 2;}
+        nx = tx; ny = ty; nz = tz;
+        newCell = cellIndex(leds, nx, ny, nz);
+      }
+
+      x[i] = nx; y[i] = ny; z[i] = nz;
+      if (newCell != cell[i]) {
+        setOccupied(cell[i], false);
+        setOccupied(newCell, true);
+        cell[i] = newCell;
+      }
+    }
+  }
+
+  void render(Leds &leds) {
+    for (unsigned16 i = 0; i < count; i++) {
+      if (prevCell[i] != cell[i] && prevCell[i] < NUM_VLEDS_Max && !isOccupied(prevCell[i]))
+        leds.setPixelColor(cellToCoord(leds, prevCell[i]), {0, 0, 0}, 0);
+      leds.setPixelColor({x[i] >> PARTICLE_SHIFT, y[i] >> PARTICLE_SHIFT, z[i] >> PARTICLE_SHIFT}, colorFromIndex(colorIndex[i]), 0);
+      prevCell[i] = cell[i];
+    }
+  }
+
+  void setOccupied(unsigned32 index, bool value) {
+    if (index >= NUM_VLEDS_Max || barrier[index >> 3] & (1 << (index & 7))) return; //barriers stay occupied
+    if (value)
+      occupied[index >> 3] |= (1 << (index & 7));
+    else
+      occupied[index >> 3] &= ~(1 << (index & 7));
+  }
+
+  bool isFree(unsigned16 i, unsigned32 index) {return index == cell[i] || !isOccupied(index);}
+
+  void setBarrier(unsigned32 index) {
+    barrier[index >> 3] |= (1 << (index & 7));
+    occupied[index >> 3] |= (1 << (index & 7));
+  }
+
+  unsigned32 cellIndex(Leds &leds, int32_t px, int32_t py, int32_t pz) {
+    return (px >> PARTICLE_SHIFT) + ((py >> PARTICLE_SHIFT) + (pz >> PARTICLE_SHIFT) * (unsigned32)leds.size.y) * leds.size.x;
+  }
+
+  Coord3D cellToCoord(Leds &leds, unsigned16 index) {
+    int xy = leds.size.x * leds.size.y;
+    return {index % leds.size.x, (index % xy) / leds.size.x, index / xy};
+  }
+};
+
+//ParticleTest before user-026: float particles, collisions by reading the framebuffer, a 27 neighbour search when blocked
+static bool isOutOfBounds(Coord3D pos, Coord3D size) {return pos.x < 0 || pos.y < 0 || pos.z < 0 || pos.x >= size.x || pos.y >= size.y || pos.z >= size.z;}
+static unsigned distanceSquared(Coord3D a, Coord3D b) {return (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) + (a.z - b.z) * (a.z - b.z);}
+static bool operator==(Coord3D a, Coord3D b) {return a.x == b.x && a.y == b.y && a.z == b.z;}
+static bool isBlack(Leds &leds, Coord3D pos) {return leds.getPixelColor(leds.XYZ(pos)) == CRGB{0, 0, 0};}
+
+struct FloatParticle {
+  float x, y, z;
+  float vx, vy, vz;
+  CRGB color;
+
+  Coord3D toCoord3DRounded() {return {int(round(x)), int(round(y)), int(round(z))};}
+
+  void updatePositionandDraw(Leds &leds) {
+    Coord3D prevPos = toCoord3DRounded();
+    x += vx; y += vy; z += vz;
+    Coord3D newPos = toCoord3DRounded();
+    if (newPos == prevPos) return;
+
+    leds.setPixelColor(prevPos, {0, 0, 0}, 0);
+
+    if (leds.isMapped(leds.XYZUnprojected(newPos)) && !isOutOfBounds(newPos, leds.size) && isBlack(leds, newPos)) {
+      leds.setPixelColor(newPos, color, 0);
+      return;
+    }
+
+    Coord3D nearestMapped = prevPos;
+    unsigned nearestDist = distanceSquared(newPos, prevPos);
+    int diff = 0;
+    bool changed = false;
+    for (int i = -1; i <= 1; i++) for (int j = -1; j <= 1; j++) for (int k = -1; k <= 1; k++) {
+      Coord3D testPos = {newPos.x + i, newPos.y + j, newPos.z + k};
+      if (testPos == prevPos) continue;
+      if (!leds.isMapped(leds.XYZUnprojected(testPos))) continue;
+      if (isOutOfBounds(testPos, leds.size)) continue;
+      if (!isBlack(leds, testPos)) continue;
+      unsigned dist = distanceSquared(testPos, newPos);
+      int differences = (prevPos.x != testPos.x) + (prevPos.y != testPos.y) + (prevPos.z != testPos.z);
+      if (dist < nearestDist || (dist == nearestDist && differences >= diff)) {
+        nearestDist = dist;
+        nearestMapped = testPos;
+        diff = differences;
+        changed = true;
+      }
+    }
+    if (changed) {
+      if (newPos.x != nearestMapped.x) vx = std::min(std::max(nearestMapped.x - prevPos.x, -1), 1);
+      if (newPos.y != nearestMapped.y) vy = std::min(std::max(nearestMapped.y - prevPos.y, -1), 1);
+      if (newPos.z != nearestMapped.z) vz = std::min(std::max(nearestMapped.z - prevPos.z, -1), 1);
+      x = nearestMapped.x; y = nearestMapped.y; z = nearestMapped.z;
+    }
+    else {
+      x -= vx; y -= vy; z -= vz;
+      Coord3D testing = toCoord3DRounded(); testing.x = newPos.x;
+      if (isOutOfBounds(testing, leds.size) || !leds.isMapped(leds.XYZUnprojected(testing))) vx = 0;
+      testing = toCoord3DRounded(); testing.y = newPos.y;
+      if (isOutOfBounds(testing, leds.size) || !leds.isMapped(leds.XYZUnprojected(testing))) vy = 0;
+      testing = toCoord3DRounded(); testing.z = newPos.z;
+      if (isOutOfBounds(testing, leds.size) || !leds.isMapped(leds.XYZUnprojected(testing))) vz = 0;
+    }
+    leds.setPixelColor(toCoord3DRounded(), color, 0);
+  }
+};
+
+//a layer with a barrier around the middle y, with gaps (as ParticleTest makes it)
+static void addBarriers(Leds &leds, Particles *particles) {
+  for (int x = 0; x < leds.size.x; x++) for (int z = 0; z < leds.size.z; z++) {
+    if (nextRandom() % 5 == 0) continue;
+    for (int y = leds.size.y / 2 - 1; y <= leds.size.y / 2; y++) {
+      leds.setPixelColor(Coord3D{x, y, z}, {255, 255, 255}, 0);
+      if (particles) particles->addBarrier(leds, {x, y, z});
+    }
+  }
+}
+
+static void scatter(Leds &leds, Particles &particles, unsigned16 amount) {
+  for (unsigned16 i = 0; i < amount; i++)
+    for (int attempts = 0; attempts < 1000; attempts++) {
+      Coord3D pos = {(int)(nextRandom() % leds.size.x), (int)(nextRandom() % leds.size.y), (int)(nextRandom() % leds.size.z)};
+      auto velocity = [] {return (int16_t)(((int16_t)(nextRandom() % 255) - 127) * 2);};
+      if (particles.add(leds, pos, velocity(), velocity(), leds.size.z > 1?velocity():0, nextRandom())) break;
+    }
+}
+
+//one particle per cell, none on a barrier, occupied bits = particles + barriers
+static bool bitmapConsistent(Leds &leds, Particles &particles) {
+  std::vector<bool> taken(NUM_VLEDS_Max);
+  for (unsigned16 i = 0; i < particles.count; i++) {
+    unsigned32 index = particles.cellIndex(leds, particles.x[i], particles.y[i], particles.z[i]);
+    if (index != particles.cell[i] || taken[index] || particles.isBarrier(index) || !particles.isOccupied(index)) return false;
+    taken[index] = true;
+  }
+  for (unsigned32 index = 0; index < NUM_VLEDS_Max; index++)
+    if (particles.isOccupied(index) != (taken[index] || particles.isBarrier(index))) return false;
+  return true;
+}
+
+int main() {
+  int failures = 0;
+
+  //bitmap check with gravity changing now and then, on a 2D and a 3D layer
+  for (int z = 1; z <= 16; z += 15) {
+    Leds leds(16, 16, z);
+    Particles particles(1024);
+    addBarriers(leds, &particles);
+    scatter(leds, particles, z == 1?100:1000);
+    bool consistent = true;
+    for (int stepNr = 0; stepNr < 20000 && consistent; stepNr++) {
+      if (stepNr % 500 == 0)
+        for (int axis = 0; axis < 3; axis++) particles.gravity[axis] = (z > 1 || axis < 2)?(int16_t)(nextRandom() % 65) - 32:0;
+      particles.step(leds);
+      particles.render(leds);
+      consistent = bitmapConsistent(leds, particles);
+    }
+    printf("16x16x%d, %d particles, 20000 steps: occupancy bitmap %s\n", z, particles.count, consistent?"consistent":"NOT consistent");
+    failures += !consistent;
+  }
+
+  //time: particles on a 16x16x16 layer with barriers, steps per second
+  for (int amount: {255, 1000}) {
+    Leds leds(16, 16, 16);
+    Particles particles(amount);
+    addBarriers(leds, &particles);
+    scatter(leds, particles, amount);
+    particles.gravity[1] = 16;
+    double fixedRate = benchRate([&](int) {particles.step(leds); particles.render(leds);}, 20000);
+    double stepRate = benchRate([&](int) {particles.step(leds);}, 20000);
+
+    Leds floatLeds(16, 16, 16);
+    addBarriers(floatLeds, nullptr);
+    std::vector<FloatParticle> floatParticles(amount);
+    for (FloatParticle &particle: floatParticles) {
+      Coord3D pos;
+      int attempts = 0;
+      do {
+        pos = {(int)(nextRandom() % 16), (int)(nextRandom() % 16), (int)(nextRandom() % 16)};
+      } while (!isBlack(floatLeds, pos) && ++attempts < 1000);
+      particle = {(float)pos.x, (float)pos.y, (float)pos.z, (nextRandom() % 256) / 128.0f - 1, (nextRandom() % 256) / 128.0f - 1, (nextRandom() % 256) / 128.0f - 1, colorFromIndex(nextRandom())};
+      floatLeds.setPixelColor(pos, particle.color, 0);
+    }
+    double floatRate = benchRate([&](int) {
+      for (FloatParticle &particle: floatParticles) {
+        particle.vy += (0.06f - particle.vy) * 0.75f; //gravity lerp as ParticleTest did
+        particle.updatePositionandDraw(floatLeds);
+      }
+    }, 20000);
+
+    printf("16x16x16, %d particles, steps per second: framebuffer probing %.0f, bitmap step + render %.0f, bitmap step only %.0f\n", amount, floatRate, fixedRate, stepRate);
+  }
+
+  return failures;
+}
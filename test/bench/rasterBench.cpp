@@ -0,0 +1,166 @@
+/*
+   @title     StarLight
+   @file      rasterBench.cpp
+   @date      20240720
+   @repo      https://github.com/MoonModules/StarLight
+   @Authors   https://github.com/MoonModules/StarLight/commits/main
+   @Copyright © 2024 Github StarLight Commit Authors
+   @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+   @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+*/
+
+// Span based 2D rasterizer (Leds::drawSpan, drawLine, fillRect) against per pixel Bresenham, primitives per second
+//   mirrors Leds::drawSpan, clipLine and drawLine in src/App/LedLeds.cpp, without the TiltPanRoll / Preset1 branch (XYZ per pixel)
+//   checks that a hard line sets the same pixels as before, and the Wu weights of an exact line
+
+#include "BenchLeds.h"
+
+//drawLine as it was before user-031: per pixel Bresenham through XY and setPixelColor, lines leaving the layer are dropped
+void drawLineOld(Leds &leds, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, CRGB color) {
+  if (x0 >= leds.size.x || x1 >= leds.size.x || y0 >= leds.size.y || y1 >= leds.size.y) return;
+  const int16_t dx = abs(x1-x0), sx = x0<x1 ? 1 : -1;
+  const int16_t dy = abs(y1-y0), sy = y0<y1 ? 1 : -1;
+  int16_t err = (dx>dy ? dx : -dy)/2, e2;
+  for (;;) {
+    leds.setPixelColor(leds.XYZ({x0, y0, 0}), color);
+    if (x0==x1 && y0==y1) break;
+    e2 = err;
+    if (e2 >-dx) { err -= dy; x0 += sx; }
+    if (e2 < dy) { err += dx; y0 += sy; }
+  }
+}
+
+void drawSpan(Leds &leds, int x0, int x1, int y, CRGB color, unsigned8 blendAmount = UINT8_MAX, int z = 0) {
+  if (x0 > x1) std::swap(x0, x1);
+  if (y < 0 || y >= leds.size.y || z < 0 || z >= leds.size.z || x1 < 0 || x0 >= leds.size.x) return;
+  x0 = std::max(x0, 0);
+  x1 = std::min(x1, leds.size.x - 1);
+  unsigned16 indexV = leds.XYZUnprojected({x0, y, z});
+  for (int x = x0; x <= x1; x++) leds.setPixelColor(indexV++, color, blendAmount);
+}
+
+//Cohen-Sutherland: clips the line to width x height, returns false if nothing is left
+static bool clipLine(int &x0, int &y0, int &x1, int &y1, int width, int height) {
+  auto outCode = [width, height](int x, int y) {return (x < 0) | ((x >= width) << 1) | ((y < 0) << 2) | ((y >= height) << 3);};
+  int code0 = outCode(x0, y0), code1 = outCode(x1, y1);
+  while (code0 | code1) {
+    if (code0 & code1) return false; //both on the same outside
+    int code = code0?code0:code1;
+    int x, y;
+    if (code & 8)      {x = x0 + (x1 - x0) * (height - 1 - y0) / (y1 - y0); y = height - 1;}
+    else if (code & 4) {x = x0 + (x1 - x0) * (0 - y0) / (y1 - y0);          y = 0;}
+    else if (code & 2) {y = y0 + (y1 - y0) * (width - 1 - x0) / (x1 - x0);  x = width - 1;}
+    else               {y = y0 + (y1 - y0) * (0 - x0) / (x1 - x0);          x = 0;}
+    if (code == code0) {x0 = x; y0 = y; code0 = outCode(x0, y0);}
+    else               {x1 = x; y1 = y; code1 = outCode(x1, y1);}
+  }
+  return true;
+}
+
+void drawLine(Leds &leds, int x0, int y0, int x1, int y1, CRGB color, bool soft = false) {
+  if (!clipLine(x0, y0, x1, y1, leds.size.x, leds.size.y)) return;
+
+  if (soft && x0 != x1 && y0 != y1) { //Wu: per step two pixels, coverage as blend amount
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) {std::swap(x0, y0); std::swap(x1, y1);}
+    if (x0 > x1) {std::swap(x0, x1); std::swap(y0, y1);}
+    int32_t gradient = ((int32_t)(y1 - y0) << 16) / (x1 - x0); //16.16 fixed point
+    int32_t y = (int32_t)y0 << 16;
+    for (int x = x0; x <= x1; x++, y += gradient) {
+      int yi = y >> 16;
+      unsigned8 frac = (y >> 8) & 0xFF;
+      //blendAmount is the share of the old pixel kept (capped at 254, UINT8_MAX means globalBlend)
+      leds.setPixelColor(steep?Coord3D{yi, x, 0}:Coord3D{x, yi, 0}, color, std::min(frac, (unsigned8)254));
+      if (frac) leds.setPixelColor(steep?Coord3D{yi + 1, x, 0}:Coord3D{x, yi + 1, 0}, color, std::min((unsigned8)(255 - frac), (unsigned8)254));
+    }
+    return;
+  }
+
+  //Bresenham, pixels on the same row collected in one span
+  const int dx = abs(x1-x0), sx = x0<x1 ? 1 : -1;
+  const int dy = abs(y1-y0), sy = y0<y1 ? 1 : -1;
+  int err = (dx>dy ? dx : -dy)/2, e2;
+  int spanStart = x0;
+  while (x0 != x1 || y0 != y1) {
+    e2 = err;
+    int nextX = x0, nextY = y0;
+    if (e2 >-dx) { err -= dy; nextX += sx; }
+    if (e2 < dy) { err += dx; nextY += sy; }
+    if (nextY != y0) {
+      drawSpan(leds, spanStart, x0, y0, color);
+      spanStart = nextX;
+    }
+    x0 = nextX; y0 = nextY;
+  }
+  drawSpan(leds, spanStart, x0, y0, color);
+}
+
+void fillRect(Leds &leds, int x, int y, int width, int height, CRGB color) {
+  int yEnd = std::min(y + height, leds.size.y);
+  for (int row = std::max(y, 0); row < yEnd; row++)
+    drawSpan(leds, x, x + width - 1, row, color);
+}
+
+static uint32_t rngState = 1;
+static uint32_t nextRandom() {rngState = rngState * 1664525 + 1013904223; return rngState >> 8;}
+
+int main() {
+  int failures = 0;
+
+  //a hard line sets the same pixels as the per pixel Bresenham (lines inside the layer, the old code dropped the others)
+  {
+    Leds before(128, 64, 1), after(128, 64, 1);
+    unsigned32 differences = 0;
+    for (int i = 0; i < 100000; i++) {
+      int x0 = nextRandom() % 128, y0 = nextRandom() % 64, x1 = nextRandom() % 128, y1 = nextRandom() % 64;
+      CRGB color = {(uint8_t)nextRandom(), (uint8_t)nextRandom(), (uint8_t)nextRandom()};
+      drawLineOld(before, x0, y0, x1, y1, color);
+      drawLine(after, x0, y0, x1, y1, color);
+      if (memcmp(before.ledsP.data(), after.ledsP.data(), before.nrOfLeds * sizeof(CRGB)) != 0) {
+        if (differences++ < 5) printf("difference: line %d,%d - %d,%d\n", x0, y0, x1, y1);
+        after.ledsP = before.ledsP;
+      }
+    }
+    printf("100000 lines, %u with different pixels than per pixel Bresenham\n", differences);
+    failures += differences != 0;
+  }
+
+  //Wu weights: the primary pixel of an exact line (frac 0) gets the full color, never the globalBlend sentinel
+  {
+    Leds leds(8, 8, 1);
+    leds.globalBlend = 128;
+    drawLine(leds, 0, 0, 7, 7, {255, 255, 255}, true);
+    bool exact = true;
+    for (int i = 0; i < 8; i++) exact &= leds.getPixelColor(i + i * 8) == CRGB{255, 255, 255};
+    printf("soft diagonal line is full color: %s\n", exact?"yes":"no");
+    failures += !exact;
+  }
+
+  //time, in millions per second, on a 128x64 layer
+  Leds leds(128, 64, 1);
+  CRGB color = {200, 100, 50};
+  const int n = 2000000;
+  std::vector<int> r(4096);
+  for (int &v: r) v = nextRandom();
+  auto rx = [&](int i, int k) {return r[(i * 4 + k) & 4095] % 128;};
+  auto ry = [&](int i, int k) {return r[(i * 4 + k) & 4095] % 64;};
+
+  printf("128x64, millions per second\n");
+  printf("random lines:     per pixel %.2f, spans %.2f\n",
+    benchRate([&](int i) {drawLineOld(leds, rx(i, 0), ry(i, 1), rx(i, 2), ry(i, 3), color);}, n) / 1e6,
+    benchRate([&](int i) {drawLine(leds, rx(i, 0), ry(i, 1), rx(i, 2), ry(i, 3), color);}, n) / 1e6);
+  printf("horizontal lines: per pixel %.2f, spans %.2f\n",
+    benchRate([&](int i) {int y = ry(i, 1); drawLineOld(leds, rx(i, 0), y, rx(i, 2), y, color);}, n) / 1e6,
+    benchRate([&](int i) {int y = ry(i, 1); drawLine(leds, rx(i, 0), y, rx(i, 2), y, color);}, n) / 1e6);
+  printf("vertical lines:   per pixel %.2f, spans %.2f\n",
+    benchRate([&](int i) {int x = rx(i, 0); drawLineOld(leds, x, ry(i, 1), x, ry(i, 3), color);}, n) / 1e6,
+    benchRate([&](int i) {int x = rx(i, 0); drawLine(leds, x, ry(i, 1), x, ry(i, 3), color);}, n) / 1e6);
+  printf("random soft (Wu) lines: %.2f\n",
+    benchRate([&](int i) {drawLine(leds, rx(i, 0), ry(i, 1), rx(i, 2), ry(i, 3), color, true);}, n) / 1e6);
+  //laserGEQ style bar: 8 vertical lines before, one rect now
+  printf("8x32 bar:         8 vertical lines %.2f, fillRect %.2f\n",
+    benchRate([&](int i) {int x = rx(i, 0) & ~7; for (int k = 0; k < 8; k++) drawLineOld(leds, x + k, 32, x + k, 63, color);}, n / 8) / 1e6,
+    benchRate([&](int i) {int x = rx(i, 0) & ~7; fillRect(leds, x, 32, 8, 32, color);}, n / 8) / 1e6);
+
+  return failures;
+}
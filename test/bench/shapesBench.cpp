@@ -0,0 +1,175 @@
+/*
+   @title     StarLight
+   @file      shapesBench.cpp
+   @date      20240720
+   @repo      https://github.com/MoonModules/StarLight
+   @Authors   https://github.com/MoonModules/StarLight/commits/main
+   @Copyright © 2024 Github StarLight Commit Authors
+   @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+   @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+*/
+
+// 3D primitives with bounding box culling (Leds::drawShell, drawPlane) against a distance test per voxel, frames per second
+//   mirrors Leds::drawShell and drawPlane in src/App/LedLeds.cpp and the SphereMove and Ripples loops in src/App/LedEffects.h
+//   checks the soft weights: a voxel fully covered gets the full color, never the globalBlend sentinel
+
+#include "BenchLeds.h"
+
+static float distance(float x1, float y1, float z1, float x2, float y2, float z2) {
+  return sqrtf((x1-x2)*(x1-x2) + (y1-y2)*(y1-y2) + (z1-z2)*(z1-z2));
+}
+
+static float constrain(float value, float low, float high) {return std::min(std::max(value, low), high);}
+
+void drawShell(Leds &leds, float cx, float cy, float cz, float radius, float thickness, CRGB color, bool soft) {
+  float edge = soft?0.5f:0; //soft: include voxels partly covered
+  float outer = radius + thickness / 2 + edge;
+  float inner = radius - thickness / 2 - edge;
+  float inner2 = inner > 0?inner * inner:-1;
+
+  //bounding box
+  int zEnd = std::min((int)floorf(cz + outer), leds.size.z - 1);
+  int yEnd = std::min((int)floorf(cy + outer), leds.size.y - 1);
+  for (int z = std::max((int)ceilf(cz - outer), 0); z <= zEnd; z++) {
+    for (int y = std::max((int)ceilf(cy - outer), 0); y <= yEnd; y++) {
+      float yz2 = (y - cy) * (y - cy) + (z - cz) * (z - cz);
+      if (yz2 > outer * outer) continue;
+
+      //the row crosses the shell in [cx - outerHalf, cx + outerHalf], minus the hole [cx - innerHalf, cx + innerHalf]
+      float outerHalf = sqrtf(outer * outer - yz2);
+      float innerHalf = (yz2 < inner2)?sqrtf(inner2 - yz2):-1;
+      int xEnd = std::min((int)floorf(cx + outerHalf), leds.size.x - 1);
+      for (int x = std::max((int)ceilf(cx - outerHalf), 0); x <= xEnd; x++) {
+        if (innerHalf >= 0 && fabsf(x - cx) < innerHalf) { //jump over the hole
+          x = (int)ceilf(cx + innerHalf) - 1;
+          continue;
+        }
+        if (soft) {
+          float distance = sqrtf((x - cx) * (x - cx) + yz2);
+          float coverage = constrain(0.5f - (fabsf(distance - radius) - thickness / 2), 0.0f, 1.0f);
+          if (coverage > 0) leds.setPixelColor({x, y, z}, color, (1 - coverage) * 254); //blendAmount: share of the old pixel kept
+        }
+        else
+          leds.setPixelColor({x, y, z}, color);
+      }
+    }
+  }
+}
+
+void drawPlane(Leds &leds, float nx, float ny, float nz, float offset, float thickness, CRGB color, bool soft) {
+  float length = sqrtf(nx * nx + ny * ny + nz * nz);
+  if (length == 0) return;
+  float normal[3] = {nx / length, ny / length, nz / length};
+  offset /= length;
+  float half = thickness / 2 + (soft?0.5f:0);
+
+  //walk the two axes the plane spans most, solve the third (dominant) axis: only voxels near the plane are visited
+  int sizes[3] = {leds.size.x, leds.size.y, leds.size.z};
+  unsigned8 a = 0; //dominant axis
+  for (unsigned8 i = 1; i < 3; i++) if (fabsf(normal[i]) > fabsf(normal[a])) a = i;
+  unsigned8 u = (a + 1) % 3, v = (a + 2) % 3;
+
+  int voxel[3];
+  for (voxel[v] = 0; voxel[v] < sizes[v]; voxel[v]++) {
+    for (voxel[u] = 0; voxel[u] < sizes[u]; voxel[u]++) {
+      float centerA = (offset - normal[u] * voxel[u] - normal[v] * voxel[v]) / normal[a];
+      float halfA = half / fabsf(normal[a]);
+      int aEnd = std::min((int)floorf(centerA + halfA), sizes[a] - 1);
+      for (voxel[a] = std::max((int)ceilf(centerA - halfA), 0); voxel[a] <= aEnd; voxel[a]++) {
+        if (soft) {
+          float distance = fabsf(normal[0] * voxel[0] + normal[1] * voxel[1] + normal[2] * voxel[2] - offset);
+          float coverage = constrain(0.5f - (distance - thickness / 2), 0.0f, 1.0f);
+          if (coverage > 0) leds.setPixelColor({voxel[0], voxel[1], voxel[2]}, color, (1 - coverage) * 254);
+        }
+        else
+          leds.setPixelColor({voxel[0], voxel[1], voxel[2]}, color);
+      }
+    }
+  }
+}
+
+//the plane as a distance test per voxel, as an effect would do it without drawPlane
+void drawPlanePerVoxel(Leds &leds, float nx, float ny, float nz, float offset, float thickness, CRGB color) {
+  float length = sqrtf(nx * nx + ny * ny + nz * nz);
+  Coord3D pos;
+  for (pos.z = 0; pos.z < leds.size.z; pos.z++)
+    for (pos.y = 0; pos.y < leds.size.y; pos.y++)
+      for (pos.x = 0; pos.x < leds.size.x; pos.x++)
+        if (fabsf((nx * pos.x + ny * pos.y + nz * pos.z - offset) / length) <= thickness / 2)
+          leds.setPixelColor(pos, color);
+}
+
+static uint32_t rngState = 1;
+static uint32_t nextRandom() {rngState = rngState * 1664525 + 1013904223; return rngState >> 8;}
+
+int main() {
+  int failures = 0;
+
+  //soft weights: voxels on the shell get the full color, the others keep a share of the old color
+  {
+    Leds leds(9, 9, 1);
+    leds.globalBlend = 128;
+    drawShell(leds, 4, 4, 0, 3, 1, {255, 255, 255}, true);
+    bool exact = leds.getPixelColor(leds.XYZUnprojected({7, 4, 0})) == CRGB{255, 255, 255} && leds.getPixelColor(leds.XYZUnprojected({4, 1, 0})) == CRGB{255, 255, 255};
+    bool center = leds.getPixelColor(leds.XYZUnprojected({4, 4, 0})) == CRGB{0, 0, 0};
+    printf("soft shell: full color on the shell %s, center untouched %s\n", exact?"yes":"no", center?"yes":"no");
+    failures += !exact || !center;
+  }
+
+  Leds leds(32, 32, 32);
+  CRGB color = {200, 100, 50};
+  bool fill = true;
+
+  //SphereMove before user-032: distance test per voxel of the cube, origin truncated through Coord3D
+  auto sphereBefore = [&](int i) {
+    if (fill) leds.fill_solid({0, 0, 0});
+    uint32_t time_interval = i;
+    Coord3D origin = {int(3.5f+sinf(time_interval)*2.5f), int(3.5f+cosf(time_interval)*2.5f), int(3.5f+cosf(time_interval)*2.0f)};
+    float diameter = 2.0f+sinf(time_interval/3.0f);
+    Coord3D pos;
+    for (pos.x=0; pos.x<leds.size.x; pos.x++)
+      for (pos.y=0; pos.y<leds.size.y; pos.y++)
+        for (pos.z=0; pos.z<leds.size.z; pos.z++) {
+          uint16_t d = distance(pos.x, pos.y, pos.z, origin.x, origin.y, origin.z);
+          if (d>diameter && d<diameter+1) leds.setPixelColor(pos, {(uint8_t)(i + nextRandom() % 64), 200, 255});
+        }
+  };
+  //SphereMove now: drawShell, bounding box only
+  auto sphereNow = [&](int i, bool soft) {
+    if (fill) leds.fill_solid({0, 0, 0});
+    uint32_t time_interval = i;
+    float diameter = 2.0f+sinf(time_interval/3.0f);
+    drawShell(leds, 3.5f+sinf(time_interval)*2.5f, 3.5f+cosf(time_interval)*2.5f, 3.5f+cosf(time_interval)*2.0f, diameter + 0.5f, 1.0f, color, soft);
+  };
+  //Ripples: one voxel per x,z column, no 3D primitive
+  auto ripples = [&](int i) {
+    if (fill) leds.fill_solid({0, 0, 0});
+    uint32_t time_interval = i;
+    Coord3D pos = {0,0,0};
+    for (pos.z=0; pos.z<leds.size.z; pos.z++) {
+      for (pos.x=0; pos.x<leds.size.x; pos.x++) {
+        float d = distance(3.5f, 3.5f, 0.0f, (float)pos.y, (float)pos.z, 0.0f) / 9.899495f * leds.size.y;
+        pos.y = floor(leds.size.y/2.0f + sinf(d/1.3f + time_interval) * leds.size.y/2.0f);
+        leds.setPixelColor(pos, color);
+      }
+    }
+  };
+  auto planePerVoxel = [&](int i) {if (fill) leds.fill_solid({0, 0, 0}); drawPlanePerVoxel(leds, 1, 2, 3 + (i & 3), 40, 1, color);};
+  auto planeNow = [&](int i) {if (fill) leds.fill_solid({0, 0, 0}); drawPlane(leds, 1, 2, 3 + (i & 3), 40, 1, color, false);};
+
+  printf("32x32x32, frames per second, drawing only\n");
+  fill = false;
+  int n = 20000;
+  printf("SphereMove: per voxel %.0f, drawShell %.0f, drawShell soft %.0f\n", benchRate(sphereBefore, n / 10), benchRate([&](int i) {sphereNow(i, false);}, n), benchRate([&](int i) {sphereNow(i, true);}, n));
+  printf("plane:      per voxel %.0f, drawPlane %.0f\n", benchRate(planePerVoxel, n / 10), benchRate(planeNow, n));
+  printf("Ripples:    %.0f\n", benchRate(ripples, n));
+
+  printf("32x32x32, frames per second, with fill_solid\n");
+  fill = true;
+  n = 2000;
+  printf("fill_solid only: %.0f\n", benchRate([&](int) {leds.fill_solid({0, 0, 0});}, n));
+  printf("SphereMove: per voxel %.0f, drawShell %.0f, drawShell soft %.0f\n", benchRate(sphereBefore, n), benchRate([&](int i) {sphereNow(i, false);}, n), benchRate([&](int i) {sphereNow(i, true);}, n));
+  printf("Ripples:    %.0f\n", benchRate(ripples, n));
+
+  return failures;
+}